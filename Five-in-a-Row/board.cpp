@@ -5,15 +5,14 @@
 #include <vector>
 #include <optional>
 #include <algorithm>
+#include <bit>
 
 using namespace Constants;
 
 // Utilities
 
-// An alias for the bitset, for brevity
-using RepType = std::bitset<2 * BOARD_SIZE>;
-
 // Sets one cell on the bitset representation
+template <typename RepType>
 void SetCrumb(RepType& of, const size_t at, const CellState to) {
 	of.set(at * 2 + 1, to != CellState::EMPTY);
 	of.set(at * 2, to == CellState::RED);
@@ -22,111 +21,123 @@ void SetCrumb(RepType& of, const size_t at, const CellState to) {
 // https://en.wikipedia.org/wiki/Quaternary_numeral_system#Relation_to_binary_and_hexadecimal
 
 // Get the cellstate from the bitset representation
+template <typename RepType>
 CellState GetState(const RepType& of, const size_t at) {
 	if (!of.test(at * 2 + 1))
 		return CellState::EMPTY;
 	return of.test(at * 2) ? CellState::RED : CellState::BLUE;
 }
 
-Board::Board() : cells{} {}
+template <size_t width, size_t height>
+BasicBoard<width, height>::BasicBoard() : cells{} {}
 
-Board::Board(const std::string_view input) {
-	if (input.length() != BOARD_SIZE) {
+template <size_t width, size_t height>
+BasicBoard<width, height>::BasicBoard(const std::string_view input) {
+	if (input.length() != SIZE) {
 		throw std::runtime_error("Could not construct Board : bad input length");
 	}
-	for (size_t i = 0; i < BOARD_SIZE; ++i) {
+	for (size_t i = 0; i < SIZE; ++i) {
 		switch (input[i]) {
 		case '*':
-			SetCrumb(cells, i, CellState::EMPTY);
 			break;
 		case 'B':
-			SetCrumb(cells, i, CellState::BLUE);
+			Place(i, CellState::BLUE);
 			break;
 		case 'R':
-			SetCrumb(cells, i, CellState::RED);
+			Place(i, CellState::RED);
 			break;
 		default: throw std::runtime_error(std::format("Could not construct Board: bad input containing \'{}\'", input[i]));
 		}
 	}
 }
 
-CellState Board::At(const size_t pos) const {
+template <size_t width, size_t height>
+CellState BasicBoard<width, height>::At(const size_t pos) const {
 #ifndef NDEBUG
-	if (pos >= BOARD_SIZE) {
-		throw std::runtime_error(std::format("Bad Board::At call: argument pos = {} was not within BOARD_SIZE = {}.",
-			pos, BOARD_SIZE));
+	if (pos >= SIZE) {
+		throw std::runtime_error(std::format("Bad Board::At call: argument pos = {} was not within Board::SIZE = {}.",
+			pos, SIZE));
 	}
 #endif // NDEBUG
 
 	return GetState(cells, pos);
 }
 
-CellState Board::At(const size_t x, const size_t y) const {
-	return At(y * BOARD_WIDTH + x);
+template <size_t width, size_t height>
+CellState BasicBoard<width, height>::At(const size_t x, const size_t y) const {
+	return At(y * width + x);
 }
 
-CellState Board::At(const std::pair<size_t, size_t> pos) const {
-	return At(pos.second * BOARD_WIDTH + pos.first);
+template <size_t width, size_t height>
+CellState BasicBoard<width, height>::At(const std::pair<size_t, size_t> pos) const {
+	return At(pos.second * width + pos.first);
 }
 
-Board Board::Play(const size_t pos, const bool blue) const {
+template <size_t width, size_t height>
+BasicBoard<width, height> BasicBoard<width, height>::Play(const size_t pos, const bool blue) const {
 #ifndef NDEBUG
-	if (pos >= BOARD_SIZE) {
-		throw std::runtime_error(std::format("Bad Board::Play call: argument pos = {} was not within BOARD_SIZE = {}.",
-			pos, BOARD_SIZE));
+	if (pos >= SIZE) {
+		throw std::runtime_error(std::format("Bad Board::Play call: argument pos = {} was not within Board::SIZE = {}.",
+			pos, SIZE));
 	}
 #endif // NDEBUG
-	Board b = *this;
-	SetCrumb(b.cells, pos, blue ? CellState::BLUE : CellState::RED);
+	BasicBoard b = *this;
+	b.Place(pos, blue ? CellState::BLUE : CellState::RED);
 	return b;
 }
 
-Board Board::Play(const size_t x, const size_t y, const bool blue) const {
-	return Play(y * BOARD_WIDTH + x, blue);
+template <size_t width, size_t height>
+BasicBoard<width, height> BasicBoard<width, height>::Play(const size_t x, const size_t y, const bool blue) const {
+	return Play(y * width + x, blue);
 }
 
-Board Board::Play(const std::pair<size_t, size_t> pos, const bool blue) const {
-	return Play(pos.second * BOARD_WIDTH + pos.first, blue);
+template <size_t width, size_t height>
+BasicBoard<width, height> BasicBoard<width, height>::Play(const std::pair<size_t, size_t> pos, const bool blue) const {
+	return Play(pos.second * width + pos.first, blue);
 }
 
-Board Board::Reset(const size_t pos) const {
+template <size_t width, size_t height>
+BasicBoard<width, height> BasicBoard<width, height>::Reset(const size_t pos) const {
 #ifndef NDEBUG
-	if (pos >= BOARD_SIZE) {
-		throw std::runtime_error(std::format("Bad Board::Reset call: argument pos = {} was not within BOARD_SIZE = {}.",
-			pos, BOARD_SIZE));
+	if (pos >= SIZE) {
+		throw std::runtime_error(std::format("Bad Board::Reset call: argument pos = {} was not within Board::SIZE = {}.",
+			pos, SIZE));
 	}
 #endif // NDEBUG
 
-	Board b = *this;
-	SetCrumb(b.cells, pos, CellState::EMPTY);
+	BasicBoard b = *this;
+	b.Place(pos, CellState::EMPTY);
 	return b;
 }
 
-Board Board::Reset(const size_t x, const size_t y) const {
-	return Reset(y * BOARD_WIDTH + x);
+template <size_t width, size_t height>
+BasicBoard<width, height> BasicBoard<width, height>::Reset(const size_t x, const size_t y) const {
+	return Reset(y * width + x);
 }
 
-Board Board::Reset(const std::pair<size_t, size_t> pos) const {
-	return Reset(pos.second * BOARD_WIDTH + pos.first);
+template <size_t width, size_t height>
+BasicBoard<width, height> BasicBoard<width, height>::Reset(const std::pair<size_t, size_t> pos) const {
+	return Reset(pos.second * width + pos.first);
 }
 
-std::optional<size_t> Board::Selected(const std::pair<double, double> cursorPos) const {
+template <size_t width, size_t height>
+std::optional<size_t> BasicBoard<width, height>::Selected(const std::pair<double, double> cursorPos) const {
 	// Transform the cursor position from window space to board space
 	const auto x = static_cast<int>(cursorPos.first) / CELL_PIXEL_WIDTH;
 	const auto y = static_cast<int>(cursorPos.second) / CELL_PIXEL_WIDTH;
 
 	// Is the board space position a cell on the board?
-	if (x < 0 || static_cast<size_t>(x) >= BOARD_WIDTH ||
-		y < 0 || static_cast<size_t>(y) >= BOARD_HEIGHT)
+	if (x < 0 || static_cast<size_t>(x) >= width ||
+		y < 0 || static_cast<size_t>(y) >= height)
 		return {};
 
 	// Is the cell empty?
-	for (size_t j = 0; j < BOARD_HEIGHT; ++j) {
-		for (size_t i = 0; i < BOARD_WIDTH; ++i) {
+	for (size_t j = 0; j < height; ++j) {
+		for (size_t i = 0; i < width; ++i) {
 			if (At(i, j) == CellState::EMPTY &&
 				i == static_cast<size_t>(x) &&
 				j == static_cast<size_t>(y)) {
-				return j * BOARD_WIDTH + i;
+				return j * width + i;
 			}
 		}
 	}
@@ -135,18 +146,19 @@ std::optional<size_t> Board::Selected(const std::pair<double, double> cursorPos)
 	return {};
 }
 
-bool Board::InRange(const size_t pos) const {
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::InRange(const size_t pos) const {
 	// If the cell is not empty, it is not considered "in range"
 	if (At(pos) != CellState::EMPTY) {
 		return false;
 	}
 
-	const auto x = pos % BOARD_WIDTH;
-	const auto y = pos / BOARD_WIDTH;
+	const auto x = pos % width;
+	const auto y = pos / width;
 
 	// Look for a piece in the intersection of the "in range" square of pos and the board
-	for (size_t j = ((y < RANGE) ? 0 : y - RANGE); j < ((y + RANGE + 1 < BOARD_HEIGHT) ? y + RANGE + 1 : BOARD_HEIGHT); ++j) {
-		for (size_t i = ((x < RANGE) ? 0 : x - RANGE); i < ((x + RANGE + 1 < BOARD_WIDTH) ? x + RANGE + 1 : BOARD_WIDTH); ++i) {
+	for (size_t j = ((y < RANGE) ? 0 : y - RANGE); j < ((y + RANGE + 1 < height) ? y + RANGE + 1 : height); ++j) {
+		for (size_t i = ((x < RANGE) ? 0 : x - RANGE); i < ((x + RANGE + 1 < width) ? x + RANGE + 1 : width); ++i) {
 			if (!(i == x && j == y) && At(i, j) != CellState::EMPTY) {
 				return true;
 			}
@@ -157,15 +169,16 @@ bool Board::InRange(const size_t pos) const {
 	return false;
 }
 
-std::vector<size_t> Board::InRangePlies() const {
+template <size_t width, size_t height>
+std::vector<size_t> BasicBoard<width, height>::InRangePlies() const {
 	// If the board the board is empty, a middle cell is chosen
 	if (Empty()) {
-		return { BOARD_SIZE / 2 + ((BOARD_HEIGHT % 2) ? 0 : BOARD_WIDTH / 2) };
+		return { SIZE / 2 + ((height % 2) ? 0 : width / 2) };
 	}
 
 	// Simply iterate the board and push back "in range" positions into the returned vector
 	std::vector<size_t> v;
-	for (size_t i = 0; i < BOARD_SIZE; ++i) {
+	for (size_t i = 0; i < SIZE; ++i) {
 		if (InRange(i)) {
 			v.push_back(i);
 		}
@@ -173,33 +186,80 @@ std::vector<size_t> Board::InRangePlies() const {
 	return v;
 }
 
+template <size_t width, size_t height>
+std::vector<size_t> BasicBoard<width, height>::ThreatPlies(const bool blue) const {
+	std::vector<size_t> wins, blocks, defences, fours;
 
-template <>
-int8_t Board::CountFive<FivesOrientation::HORIZONTAL>(const size_t root) const {
-#ifndef NDEBUG
-	if (std::none_of(HORIZONTAL_FIVES_ROOTS.begin(), HORIZONTAL_FIVES_ROOTS.end(), [root](size_t i) {
-		return i == root;
-	})) {
-		throw std::out_of_range("The \"five\" does not exist");
-	}
-#endif // NDEBUG
-	int8_t count{};
-	for (size_t i = 0; i < 5; ++i) {
-		auto state = GetState(cells, root + i); // Right
-		if ((state == CellState::BLUE && count > 0) ||
-			(state == CellState::RED && count < 0)) {
-			return 0;
+	// Pushes back the cells of the line at the set bits of mask
+	auto push = [&](std::vector<size_t>& plies, const size_t line, uint32_t mask) {
+		for (; mask; mask &= mask - 1) {
+			plies.push_back(Geometry::LINE_CELLS[line][std::countr_zero(mask)]);
+		}
+	};
+
+	for (size_t line = 0; line < Geometry::LINE_COUNT; ++line) {
+		const size_t length = Geometry::LINE_LENGTHS[line];
+		if (length < 5) continue;
+		const uint32_t own = blue ? blueLines[line] : redLines[line];
+		const uint32_t other = blue ? redLines[line] : blueLines[line];
+		const uint32_t empty = ~(own | other) & ((1u << length) - 1);
+
+		// The "fives" which the color to move can complete, block, or make a four of
+		for (size_t k = 0; k + 5 <= length; ++k) {
+			const uint32_t five = 31u << k;
+			const auto owned = std::popcount(own & five);
+			const auto others = std::popcount(other & five);
+			if (owned == 4 && !others) push(wins, line, empty & five);
+			else if (others == 4 && !owned) push(blocks, line, empty & five);
+			else if (owned == 3 && !others) push(fours, line, empty & five);
+		}
+
+		// The opponent's open threes: six cells with empty ends and three of the opponent's pieces
+		// in between, which one more piece makes an open four (_XXXX_)
+		for (size_t k = 0; k + 6 <= length; ++k) {
+			const uint32_t ends = (1u << k) | (1u << (k + 5));
+			const uint32_t inner = 15u << (k + 1);
+			if ((empty & ends) == ends && !(own & inner) && std::popcount(other & inner) == 3) {
+				push(defences, line, (empty & inner) | ends);
+			}
 		}
-		count += (state == CellState::RED);
-		count -= (state == CellState::BLUE);
 	}
-	return count;
+
+	auto unique = [](std::vector<size_t> plies) {
+		std::sort(plies.begin(), plies.end());
+		plies.erase(std::unique(plies.begin(), plies.end()), plies.end());
+		return plies;
+	};
+	if (!wins.empty()) return unique(std::move(wins));
+	if (!blocks.empty()) return unique(std::move(blocks));
+	if (!defences.empty()) {
+		defences.insert(defences.end(), fours.begin(), fours.end());
+		return unique(std::move(defences));
+	}
+	return {};
 }
 
-template <>
-int8_t Board::CountFive<FivesOrientation::VERTICAL>(const size_t root) const {
+template <size_t width, size_t height>
+std::vector<size_t> BasicBoard<width, height>::CandidatePlies(const bool blue) const {
+	if (auto plies = ThreatPlies(blue); !plies.empty()) {
+		return plies;
+	}
+	return InRangePlies();
+}
+
+
+template <size_t width, size_t height>
+template <FivesOrientation orientation>
+int8_t BasicBoard<width, height>::CountFive(const size_t root) const {
+	// The distance between two consecutive cells of the orientation's "fives"
+	constexpr size_t stride =
+		orientation == FivesOrientation::HORIZONTAL ? 1 : // Right
+		orientation == FivesOrientation::VERTICAL ? width : // Down
+		orientation == FivesOrientation::SOUTHEAST ? width + 1 : // Down and right
+		width - 1; // Down and left
 #ifndef NDEBUG
-	if (std::none_of(VERTICAL_FIVES_ROOTS.begin(), VERTICAL_FIVES_ROOTS.end(), [root](size_t index) {
+	constexpr const auto& roots = FivesRoots<orientation>();
+	if (std::none_of(roots.begin(), roots.end(), [root](size_t index) {
 		return index == root;
 	})) {
 		throw std::out_of_range("The \"five\" does not exist");
@@ -207,7 +267,7 @@ int8_t Board::CountFive<FivesOrientation::VERTICAL>(const size_t root) const {
 #endif // NDEBUG
 	int8_t count{};
 	for (size_t i = 0; i < 5; ++i) {
-		auto state = GetState(cells, root + i * BOARD_WIDTH); // Down
+		auto state = GetState(cells, root + i * stride);
 		if ((state == CellState::BLUE && count > 0) ||
 			(state == CellState::RED && count < 0)) {
 			return 0;
@@ -218,79 +278,257 @@ int8_t Board::CountFive<FivesOrientation::VERTICAL>(const size_t root) const {
 	return count;
 }
 
-template <>
-int8_t Board::CountFive<FivesOrientation::SOUTHEAST>(const size_t root) const {
-#ifndef NDEBUG
-	if (std::none_of(SOUTHEAST_FIVES_ROOTS.begin(), SOUTHEAST_FIVES_ROOTS.end(), [root](size_t index) {
-		return index == root;
-	})) {
-		throw std::out_of_range("The \"five\" does not exist");
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::WinThrough(const size_t pos) const {
+	const auto state = At(pos);
+	if (state == CellState::EMPTY) {
+		return false;
 	}
-#endif // NDEBUG
-	int8_t count{};
-	for (size_t i = 0; i < 5; ++i) {
-		auto state = GetState(cells, root + i * BOARD_WIDTH + i); // Down and right
-		if ((state == CellState::BLUE && count > 0) ||
-			(state == CellState::RED && count < 0)) {
-			return 0;
+	const auto& fives = Geometry::CELL_FIVES[pos];
+	return std::any_of(fives.begin(), fives.begin() + Geometry::CELL_FIVES_COUNT[pos], [&](const uint16_t five) {
+		const auto& cells = Geometry::FIVE_CELLS[Geometry::FiveIndex(five)];
+		return std::all_of(cells.begin(), cells.end(), [&](const uint16_t cell) {
+			return GetState(this->cells, cell) == state;
+		});
+	});
+}
+
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::Tactical(const size_t pos, const size_t pieces) const {
+	for (const auto [line, position] : Geometry::CELL_LINES[pos]) {
+		const size_t length = Geometry::LINE_LENGTHS[line];
+		if (length < 5) continue;
+
+		// The "fives" through pos start at offsets first through last of the line
+		const size_t first = position > 4 ? position - 4 : 0;
+		const size_t last = position < length - 5 ? position : length - 5;
+		for (size_t k = first; k <= last; ++k) {
+			const auto red = std::popcount((static_cast<uint32_t>(redLines[line]) >> k) & 31u);
+			const auto blue = std::popcount((static_cast<uint32_t>(blueLines[line]) >> k) & 31u);
+			if (static_cast<size_t>(red + blue) >= pieces && !(red && blue)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::WinsAt(const size_t pos, const bool blue) const {
+	for (const auto [line, position] : Geometry::CELL_LINES[pos]) {
+		const size_t length = Geometry::LINE_LENGTHS[line];
+		if (length < 5) continue;
+
+		const uint32_t own = blue ? blueLines[line] : redLines[line];
+		const uint32_t other = blue ? redLines[line] : blueLines[line];
+		const size_t first = position > 4 ? position - 4 : 0;
+		const size_t last = position < length - 5 ? position : length - 5;
+		for (size_t k = first; k <= last; ++k) {
+			if (std::popcount((own >> k) & 31u) == 4 && !((other >> k) & 31u)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+template <size_t width, size_t height>
+size_t BasicBoard<width, height>::ThreatsAt(const size_t pos, const bool blue) const {
+	// At most 4 lines of 5 "fives" through pos, each with one cell left
+	std::array<size_t, 20> threats;
+	size_t count = 0;
+	for (const auto [line, position] : Geometry::CELL_LINES[pos]) {
+		const size_t length = Geometry::LINE_LENGTHS[line];
+		if (length < 5) continue;
+
+		const uint32_t own = blue ? blueLines[line] : redLines[line];
+		const uint32_t other = blue ? redLines[line] : blueLines[line];
+		const size_t first = position > 4 ? position - 4 : 0;
+		const size_t last = position < length - 5 ? position : length - 5;
+		for (size_t k = first; k <= last; ++k) {
+			// Three of the color's pieces, pos, and the threat
+			const uint32_t five = 31u << k;
+			if (std::popcount(own & five) == 3 && !(other & five)) {
+				const auto rest = five & ~own & ~(1u << position);
+				const size_t cell = Geometry::LINE_CELLS[line][std::countr_zero(rest)];
+				if (std::find(threats.begin(), threats.begin() + count, cell) == threats.begin() + count) {
+					threats[count++] = cell;
+				}
+			}
 		}
-		count += (state == CellState::RED);
-		count -= (state == CellState::BLUE);
 	}
 	return count;
 }
 
-template <>
-int8_t Board::CountFive<FivesOrientation::SOUTHWEST>(const size_t root) const {
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::BlueWin() const {
+	return blueFives;
+}
+
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::RedWin() const {
+	return redFives;
+}
+
+template <size_t width, size_t height>
+Score BasicBoard<width, height>::PatternScore() const {
+	return patternScore;
+}
+
+template <size_t width, size_t height>
+void BasicBoard<width, height>::Place(const size_t pos, const CellState to) {
+	UpdatePatterns(pos, -1);
+
+	// XOR the old piece out and the new one in, for every symmetry at once
+	const auto& zobrist = Geometry::ZOBRIST_KEYS[pos];
+	for (const auto state : { GetState(cells, pos), to }) {
+		if (state == CellState::EMPTY) continue;
+		const auto& stateKeys = zobrist[state == CellState::BLUE];
+		for (size_t s = 0; s < Geometry::SYMMETRY_COUNT; ++s) {
+			keys[s] ^= stateKeys[s];
+		}
+	}
+
+	SetCrumb(cells, pos, to);
+	for (const auto [line, position] : Geometry::CELL_LINES[pos]) {
+		const auto bit = static_cast<LineMask>(1u << position);
+		redLines[line] = (redLines[line] & ~bit) | (to == CellState::RED ? bit : 0);
+		blueLines[line] = (blueLines[line] & ~bit) | (to == CellState::BLUE ? bit : 0);
+	}
+
+	UpdatePatterns(pos, 1);
+}
+
+template <size_t width, size_t height>
+void BasicBoard<width, height>::UpdatePatterns(const size_t pos, const int sign) {
+	for (const auto [line, position] : Geometry::CELL_LINES[pos]) {
+		const size_t length = Geometry::LINE_LENGTHS[line];
+		if (length < 5) continue;
+
+		// Pad the line with a wall at either end, which is both red and blue
+		const uint32_t wall = 1u | (1u << (length + 1));
+		const uint32_t red = (static_cast<uint32_t>(redLines[line]) << 1) | wall;
+		const uint32_t blue = (static_cast<uint32_t>(blueLines[line]) << 1) | wall;
+
+		// The windows start at offsets 0 through length - 4 of the padded line, and pos is at padded
+		const size_t padded = static_cast<size_t>(position) + 1;
+		const size_t first = padded > 5 ? padded - 5 : 0;
+		const size_t last = padded < length - 4 ? padded : length - 4;
+		for (size_t k = first; k <= last; ++k) {
+			const auto& entry = PATTERN_TABLE[((red >> k) & 63) | (((blue >> k) & 63) << 6)];
+			patternScore += sign * entry.score;
+			redFives += sign * (entry.five > 0);
+			redLive += sign * (entry.live & 1);
+			blueLive += sign * (entry.live >> 1);
+			blueFives += sign * (entry.five < 0);
+		}
+	}
+}
+
+template <size_t width, size_t height>
+uint64_t BasicBoard<width, height>::Key() const {
+	return keys[0];
+}
+
+template <size_t width, size_t height>
+CanonicalKey BasicBoard<width, height>::Canonical() const {
+	const auto min = std::min_element(keys.begin(), keys.end());
+	return { *min, static_cast<uint8_t>(min - keys.begin()) };
+}
+
+template <size_t width, size_t height>
+BasicBoard<width, height> BasicBoard<width, height>::Transformed(const uint8_t symmetry) const {
 #ifndef NDEBUG
-	if (std::none_of(SOUTHWEST_FIVES_ROOTS.begin(), SOUTHWEST_FIVES_ROOTS.end(), [root](size_t index) {
-		return index == root;
-	})) {
-		throw std::out_of_range("The \"five\" does not exist");
+	if (symmetry >= Geometry::SYMMETRY_COUNT) {
+		throw std::runtime_error(std::format("Bad Board::Transformed call: argument symmetry = {} was not within Board::Geometry::SYMMETRY_COUNT = {}.",
+			symmetry, Geometry::SYMMETRY_COUNT));
 	}
 #endif // NDEBUG
-	int8_t count{};
-	for (size_t i = 0; i < 5; ++i) {
-		auto state = GetState(cells, root + i * BOARD_WIDTH - i); // Down and left
-		if ((state == CellState::BLUE && count > 0) ||
-			(state == CellState::RED && count < 0)) {
-			return 0;
-		}
-		count += (state == CellState::RED);
-		count -= (state == CellState::BLUE);
+
+	BasicBoard b;
+	for (size_t pos = 0; pos < SIZE; ++pos) {
+		const auto state = GetState(cells, pos);
+		if (state != CellState::EMPTY) b.Place(Transform(pos, symmetry), state);
 	}
-	return count;
+	return b;
 }
 
-bool Board::BlueWin() const {
-	return std::any_of(HORIZONTAL_FIVES_ROOTS.begin(), HORIZONTAL_FIVES_ROOTS.end(),
-		[&](const size_t root) { return CountFive<FivesOrientation::HORIZONTAL>(root) == -5; })
-		|| std::any_of(VERTICAL_FIVES_ROOTS.begin(), VERTICAL_FIVES_ROOTS.end(),
-			[&](const size_t root) { return CountFive<FivesOrientation::VERTICAL>(root) == -5; })
-		|| std::any_of(SOUTHEAST_FIVES_ROOTS.begin(), SOUTHEAST_FIVES_ROOTS.end(),
-			[&](const size_t root) { return CountFive<FivesOrientation::SOUTHEAST>(root) == -5; })
-		|| std::any_of(SOUTHWEST_FIVES_ROOTS.begin(), SOUTHWEST_FIVES_ROOTS.end(),
-			[&](const size_t root) { return CountFive<FivesOrientation::SOUTHWEST>(root) == -5; });
+template <size_t width, size_t height>
+size_t BasicBoard<width, height>::Transform(const size_t pos, const uint8_t symmetry) {
+#ifndef NDEBUG
+	if (pos >= SIZE || symmetry >= Geometry::SYMMETRY_COUNT) {
+		throw std::runtime_error(std::format("Bad Board::Transform call: arguments pos = {}, symmetry = {} were not within Board::SIZE = {}, Board::Geometry::SYMMETRY_COUNT = {}.",
+			pos, symmetry, SIZE, Geometry::SYMMETRY_COUNT));
+	}
+#endif // NDEBUG
+
+	return Geometry::SYMMETRY_CELLS[symmetry][pos];
 }
 
-bool Board::RedWin() const {
-	return std::any_of(HORIZONTAL_FIVES_ROOTS.begin(), HORIZONTAL_FIVES_ROOTS.end(),
-		[&](const size_t root) { return CountFive<FivesOrientation::HORIZONTAL>(root) == 5; })
-		|| std::any_of(VERTICAL_FIVES_ROOTS.begin(), VERTICAL_FIVES_ROOTS.end(),
-			[&](const size_t root) { return CountFive<FivesOrientation::VERTICAL>(root) == 5; })
-		|| std::any_of(SOUTHEAST_FIVES_ROOTS.begin(), SOUTHEAST_FIVES_ROOTS.end(),
-			[&](const size_t root) { return CountFive<FivesOrientation::SOUTHEAST>(root) == 5; })
-		|| std::any_of(SOUTHWEST_FIVES_ROOTS.begin(), SOUTHWEST_FIVES_ROOTS.end(),
-			[&](const size_t root) { return CountFive<FivesOrientation::SOUTHWEST>(root) == 5; });
+template <size_t width, size_t height>
+size_t BasicBoard<width, height>::InverseTransform(const size_t pos, const uint8_t symmetry) {
+#ifndef NDEBUG
+	if (pos >= SIZE || symmetry >= Geometry::SYMMETRY_COUNT) {
+		throw std::runtime_error(std::format("Bad Board::InverseTransform call: arguments pos = {}, symmetry = {} were not within Board::SIZE = {}, Board::Geometry::SYMMETRY_COUNT = {}.",
+			pos, symmetry, SIZE, Geometry::SYMMETRY_COUNT));
+	}
+#endif // NDEBUG
+
+	return Geometry::SYMMETRY_CELLS[INVERSE_SYMMETRY[symmetry]][pos];
 }
 
-bool Board::Empty() const {
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::Empty() const {
 	return !cells.any();
 }
 
-bool Board::Full() const {
-	for (size_t i = 0; i < BOARD_SIZE; ++i) {
-		if (At(i) == CellState::EMPTY) return false;
-	}
-	return true;
-}
\ No newline at end of file
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::Full() const {
+	// The upper bit of every crumb is set if the cell is occupied (see SetCrumb)
+	static const auto occupied = []() {
+		std::bitset<2 * SIZE> mask;
+		for (size_t i = 0; i < SIZE; ++i) {
+			mask.set(i * 2 + 1);
+		}
+		return mask;
+	}();
+	return (cells & occupied).count() == SIZE;
+}
+
+template <size_t width, size_t height>
+bool BasicBoard<width, height>::Drawn() const {
+	return !redLive && !blueLive;
+}
+
+AnyBoard MakeBoard(const size_t width, const size_t height) {
+	if (width == 15 && height == 15) return BasicBoard<15, 15>{};
+	if (width == 19 && height == 19) return BasicBoard<19, 19>{};
+	if (width == 7 && height == 7) return BasicBoard<7, 7>{};
+	throw std::runtime_error(std::format("Could not make a board of {}x{}: the size is not instantiated", width, height));
+}
+
+// Explicit instantiations, which must match AnyBoard
+
+template class BasicBoard<15, 15>;
+template int8_t BasicBoard<15, 15>::CountFive<FivesOrientation::HORIZONTAL>(const size_t) const;
+template int8_t BasicBoard<15, 15>::CountFive<FivesOrientation::VERTICAL>(const size_t) const;
+template int8_t BasicBoard<15, 15>::CountFive<FivesOrientation::SOUTHEAST>(const size_t) const;
+template int8_t BasicBoard<15, 15>::CountFive<FivesOrientation::SOUTHWEST>(const size_t) const;
+
+template class BasicBoard<19, 19>;
+template int8_t BasicBoard<19, 19>::CountFive<FivesOrientation::HORIZONTAL>(const size_t) const;
+template int8_t BasicBoard<19, 19>::CountFive<FivesOrientation::VERTICAL>(const size_t) const;
+template int8_t BasicBoard<19, 19>::CountFive<FivesOrientation::SOUTHEAST>(const size_t) const;
+template int8_t BasicBoard<19, 19>::CountFive<FivesOrientation::SOUTHWEST>(const size_t) const;
+
+template class BasicBoard<7, 7>;
+template int8_t BasicBoard<7, 7>::CountFive<FivesOrientation::HORIZONTAL>(const size_t) const;
+template int8_t BasicBoard<7, 7>::CountFive<FivesOrientation::VERTICAL>(const size_t) const;
+template int8_t BasicBoard<7, 7>::CountFive<FivesOrientation::SOUTHEAST>(const size_t) const;
+template int8_t BasicBoard<7, 7>::CountFive<FivesOrientation::SOUTHWEST>(const size_t) const;
+
+// The configured board must be one of the instantiated ones
+static_assert(std::is_same_v<Board, std::variant_alternative_t<0, AnyBoard>> ||
+	std::is_same_v<Board, std::variant_alternative_t<1, AnyBoard>> ||
+	std::is_same_v<Board, std::variant_alternative_t<2, AnyBoard>>,
+	"The configured board dimensions must be added to AnyBoard and instantiated in board.cpp");
\ No newline at end of file
@@ -1,7 +1,13 @@
-// This header contains the declarations of the Board class and cell state,
-// which encapsulate a board state in a memory-efficient manner
+// This header contains the declarations of the Board class and cell state, which encapsulate a board state.
+// Besides the cells, a board carries incremental state: the line masks, the pattern totals, the live "fives" counts
+// and the Zobrist keys of every symmetry, about 500 bytes on 15x15, all of which every Play copies.
+// That is the trade-off for constant-time evaluation, keys and win and draw checks
 // It is also entirely const and therefore threadsafe! Yay for value-semantics
 
+// The board is templated on its dimensions, so that every size has its own compile-time
+// "five" tables and loops. The supported sizes are explicitly instantiated in board.cpp,
+// and AnyBoard dispatches between them at runtime.
+
 #pragma once
 
 #include "constants.hpp"
@@ -10,6 +16,11 @@
 #include <bitset>
 #include <utility>
 #include <optional>
+#include <variant>
+#include <vector>
+#include <array>
+#include <type_traits>
+#include <cstdint>
 
 // The state of a cell
 enum class CellState { EMPTY, BLUE, RED };
@@ -17,13 +28,27 @@ enum class CellState { EMPTY, BLUE, RED };
 // The orientations of possible five-in-a-rows
 enum class FivesOrientation { HORIZONTAL, VERTICAL, SOUTHEAST, SOUTHWEST };
 
-class Board {
+// A key shared by every symmetric form of a position: the smallest of their Zobrist keys, and the
+// symmetry which maps the board onto the form that has it (the canonical form)
+struct CanonicalKey {
+	uint64_t key;
+	uint8_t symmetry;
+};
+
+template <size_t width, size_t height>
+class BasicBoard {
 public:
+	// The compile-time constants of this board size
+	using Geometry = Constants::BoardGeometry<width, height>;
+	static constexpr size_t WIDTH = width;
+	static constexpr size_t HEIGHT = height;
+	static constexpr size_t SIZE = width * height;
+
 	// Creates an empty board.
-	Board();
+	BasicBoard();
 
 	// For testing. '*' is EMPTY, 'B' is BLUE and 'R' is RED.
-	Board(const std::string_view input);
+	BasicBoard(const std::string_view input);
 
 	// Returns the state of the cell at position pos
 	CellState At(const size_t pos) const;
@@ -33,18 +58,18 @@ public:
 	CellState At(const std::pair<size_t, size_t> pos) const;
 
 	// Returns the board resulting from playing a piece at pos
-	Board Play(const size_t pos, const bool blue) const;
+	BasicBoard Play(const size_t pos, const bool blue) const;
 	// Returns the board resulting from playing a piece at (x,y)
-	Board Play(const size_t x, const size_t y, const bool blue) const;
+	BasicBoard Play(const size_t x, const size_t y, const bool blue) const;
 	// Returns the board resulting from playing a piece at pos
-	Board Play(const std::pair<size_t, size_t> pos, const bool blue) const;
+	BasicBoard Play(const std::pair<size_t, size_t> pos, const bool blue) const;
 
 	// Returns the board resulting from removing a piece at pos
-	Board Reset(const size_t pos) const;
+	BasicBoard Reset(const size_t pos) const;
 	// Returns the board resulting from removing a piece at (x,y)
-	Board Reset(const size_t x, const size_t y) const;
+	BasicBoard Reset(const size_t x, const size_t y) const;
 	// Returns the board resulting from removing a piece at pos
-	Board Reset(const std::pair<size_t, size_t> pos) const;
+	BasicBoard Reset(const std::pair<size_t, size_t> pos) const;
 
 	// Returns the position of the empty cell selected by cursorPosition, if existent
 	std::optional<size_t> Selected(const std::pair<double, double> cursorPosition) const;
@@ -55,22 +80,107 @@ public:
 	// Returns a vector containing all current "in range" positions on the board
 	std::vector<size_t> InRangePlies() const;
 
+	// Returns the plies forced by the threats on the board, for the color to move: its winning plies,
+	// else the plies blocking the opponent's fours, else the plies defending against the opponent's open threes
+	// (blocking them, or making a four). Empty if there are no such threats
+	std::vector<size_t> ThreatPlies(const bool blue) const;
+	// Returns the plies worth considering for the color to move: ThreatPlies, or InRangePlies if there are none
+	std::vector<size_t> CandidatePlies(const bool blue) const;
+
+	template <FivesOrientation orientation>
+	// Returns the roots of all "fives" along the orientation
+	static constexpr const auto& FivesRoots() {
+		if constexpr (orientation == FivesOrientation::HORIZONTAL) return Geometry::HORIZONTAL_FIVES_ROOTS;
+		else if constexpr (orientation == FivesOrientation::VERTICAL) return Geometry::VERTICAL_FIVES_ROOTS;
+		else if constexpr (orientation == FivesOrientation::SOUTHEAST) return Geometry::SOUTHEAST_FIVES_ROOTS;
+		else return Geometry::SOUTHWEST_FIVES_ROOTS;
+	}
+
 	template <FivesOrientation orientation>
 	// Counts pieces along the orientation, from root
 	// If positive, the count of red pieces; if negative, the count of blue pieces;
 	// if zero, empty or or containing both
 	int8_t CountFive(const size_t root) const;
 
+	// Does the piece at pos complete a five-in-a-row? (Only looks at the "fives" through pos)
+	bool WinThrough(const size_t pos) const;
+
+	// Is a ply at pos tactical? I.e. does a "five" through pos hold at least pieces pieces of one color
+	// and none of the other, so that playing there extends or blocks it
+	bool Tactical(const size_t pos, const size_t pieces) const;
+
+	// Would the color complete a five-in-a-row by playing the empty cell pos?
+	bool WinsAt(const size_t pos, const bool blue) const;
+	// Returns the number of distinct cells which would complete a five-in-a-row for the color once it has played
+	// the empty cell pos, among the "fives" through pos. Two or more are a threat the opponent can't block
+	// (an open four, or two fours)
+	size_t ThreatsAt(const size_t pos, const bool blue) const;
+
 	// Does blue have five-in-a-row?
 	bool BlueWin() const;
 	// Does red have five-in-a-row?
 	bool RedWin() const;
 
+	// Returns the sum of the pattern table over every six-cell window of every line (red positive),
+	// excluding five-in-a-rows. It is maintained incrementally, so this is constant time
+	Score PatternScore() const;
+
+	// Returns the Zobrist key of the board. It is maintained incrementally, so this is constant time
+	uint64_t Key() const;
+	// Returns the canonical key of the board, from the keys of its symmetric forms (8 if square, else 4),
+	// which are maintained incrementally alongside Key
+	CanonicalKey Canonical() const;
+	// Returns the board mapped by the symmetry (see Constants::SYMMETRY_CELLS_GENERATOR).
+	// Transformed(Canonical().symmetry).Key() == Canonical().key
+	BasicBoard Transformed(const uint8_t symmetry) const;
+
+	// Maps a position on this board to the same cell on the board mapped by the symmetry
+	static size_t Transform(const size_t pos, const uint8_t symmetry);
+	// Maps a position on the board mapped by the symmetry back to this board,
+	// e.g. a move found for the canonical form
+	static size_t InverseTransform(const size_t pos, const uint8_t symmetry);
+
 	// Is the board empty?
 	bool Empty() const;
 	// Is the board full?
 	bool Full() const;
+	// Is the board a draw? I.e. is every "five" blocked for both colors, so that neither can win any more.
+	// Like the win checks, this is constant time, and it is true long before the board is full
+	bool Drawn() const;
 private:
+	// A line's cells of one color, one bit each
+	using LineMask = std::conditional_t<(width <= 16 && height <= 16), uint16_t, uint32_t>;
+
+	// Sets the cell at pos, keeping the line masks, pattern totals and keys up to date
+	void Place(const size_t pos, const CellState to);
+
+	// Adds (sign = 1) or subtracts (sign = -1) the pattern table entries of every window through pos
+	void UpdatePatterns(const size_t pos, const int sign);
+
 	// The underlying board state representation
-	std::bitset<2 * Constants::BOARD_SIZE> cells;
-};
\ No newline at end of file
+	std::bitset<2 * SIZE> cells;
+
+	// The cells of every line, as bit masks per color
+	std::array<LineMask, Geometry::LINE_COUNT> redLines{};
+	std::array<LineMask, Geometry::LINE_COUNT> blueLines{};
+
+	// The running totals of the pattern table
+	Score patternScore{};
+	uint16_t redFives{};
+	uint16_t blueFives{};
+	// The "fives" which red or blue could still complete, all of them on the empty board
+	uint16_t redLive{ static_cast<uint16_t>(Geometry::FIVES_COUNT) };
+	uint16_t blueLive{ static_cast<uint16_t>(Geometry::FIVES_COUNT) };
+
+	// The Zobrist keys of the board mapped by every symmetry, keys[0] being that of the board itself
+	std::array<uint64_t, Geometry::SYMMETRY_COUNT> keys{};
+};
+
+// The board of the configured dimensions, which the game is played on
+using Board = BasicBoard<Constants::BOARD_WIDTH, Constants::BOARD_HEIGHT>;
+
+// Every explicitly instantiated board: 15x15 (standard), 19x19 (Go board) and 7x7 (for testing)
+using AnyBoard = std::variant<BasicBoard<15, 15>, BasicBoard<19, 19>, BasicBoard<7, 7>>;
+
+// Returns an empty board of the given dimensions. Throws if they are not instantiated
+AnyBoard MakeBoard(const size_t width, const size_t height);
\ No newline at end of file
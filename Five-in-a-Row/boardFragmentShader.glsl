@@ -0,0 +1,12 @@
+#version 330 core
+
+in vec2 fragmentCoordinate;
+flat in vec4 color;
+flat in float circle;
+
+out vec4 fragColor;
+
+void main() {
+	// Still branchless: a circle is transparent outside the unit radius, a square nowhere
+	fragColor = color * float(circle == 0.0 || dot(fragmentCoordinate, fragmentCoordinate) <= 1.0);
+}
\ No newline at end of file
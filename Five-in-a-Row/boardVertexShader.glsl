@@ -0,0 +1,20 @@
+#version 330 core
+
+layout (location = 0) in vec2 vertexAttribute;
+
+// Per instance: where the square goes, how big it is, its color, and whether it's cut to a circle
+layout (location = 1) in vec2 offsetAttribute;
+layout (location = 2) in vec2 scaleAttribute;
+layout (location = 3) in vec4 colorAttribute;
+layout (location = 4) in float circleAttribute;
+
+out vec2 fragmentCoordinate;
+flat out vec4 color;
+flat out float circle;
+
+void main() {
+	gl_Position = vec4(vertexAttribute * scaleAttribute + offsetAttribute, 0.0, 1.0);
+	fragmentCoordinate = vertexAttribute;
+	color = colorAttribute;
+	circle = circleAttribute;
+}
\ No newline at end of file
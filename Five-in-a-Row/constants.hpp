@@ -6,6 +6,11 @@
 #include <limits>
 #include <vector>
 #include <array>
+#include <cstdint>
+
+// The score of a position, for the goal functions and the search. Integers sum the same in any order,
+// so every reduction policy gives the same result, and the scores in use fit in 16 bits (see Constants::WIN_SCORE)
+using Score = int32_t;
 
 namespace Constants {
 
@@ -25,6 +30,15 @@ namespace Constants {
 	constexpr float PIECE_INNER_FACTOR = 0.8f;	static_assert(0.0f < PIECE_INNER_FACTOR && PIECE_INNER_FACTOR < 1.0f);
 	constexpr float OUTER_COLOR_FACTOR = 0.7f;	static_assert(0.0f < OUTER_COLOR_FACTOR && OUTER_COLOR_FACTOR < 1.0f);
 
+	// Shaders
+
+	// Whether the shaders are loaded from their files (see ShaderSources) instead of the built-in sources,
+	// to edit them without rebuilding
+	constexpr bool SHADER_FILES = false;
+	// Where the linked program is cached by the driver's binary of it, to skip compiling it on the next start.
+	// Empty disables the cache
+	constexpr const char* SHADER_CACHE_PATH = "shaderCache.bin";
+
 	// Window title
 
 	constexpr const char* APPLICATION_NAME = "Five in a Row - ";
@@ -33,6 +47,8 @@ namespace Constants {
 	constexpr const char* PLAYER_WIN_SUFFIX = "You won!";
 	constexpr const char* COMPUTER_WIN_SUFFIX = "You lost!";
 	constexpr const char* DRAW_SUFFIX = "Draw!";
+	// How often the title shows the progress of the computer's search, in seconds
+	constexpr double PROGRESS_SECONDS = 0.1;		static_assert(PROGRESS_SECONDS > 0.0);
 
 	// AI related
 	
@@ -46,14 +62,120 @@ namespace Constants {
 	// on their immediate goal function score
 	constexpr size_t SORTING_DEPTH = 2;
 
+	// Whether the minimax only considers the plies forced by the threats on the board, when there are any
+	// (see Board::ThreatPlies), instead of every in-range ply
+	constexpr bool THREAT_CANDIDATES = true;
+
+	// A ply is tactical if a "five" through it holds at least TACTICAL_PIECES pieces of one color and none
+	// of the other (see Board::Tactical). The prunings below only ever skip or shorten quiet (not tactical) plies
+	constexpr size_t TACTICAL_PIECES = 2;			static_assert(TACTICAL_PIECES > 0 && TACTICAL_PIECES < 5);
+
+	// Late move reductions: at depths of at least LMR_MIN_DEPTH, the quiet children after the first LMR_FULL_MOVES
+	// (in search order) are searched one ply shallower, and only searched again to full depth if that looks better
+	constexpr bool LATE_MOVE_REDUCTIONS = true;
+	constexpr size_t LMR_MIN_DEPTH = 3;				static_assert(LMR_MIN_DEPTH >= 2);
+	constexpr size_t LMR_FULL_MOVES = 4;
+
+	// Futility pruning: one ply above the horizon, the quiet children are skipped if the goal function of the node
+	// plus FUTILITY_MARGIN can't reach the window. The goal function can gain at most 20 "fives" times 7 from
+	// a quiet ply (1 to 8, or destroying the opponent's 1), so at TACTICAL_PIECES = 2 it never skips a better one
+	constexpr bool FUTILITY_PRUNING = true;
+	constexpr Score FUTILITY_MARGIN = 150;			static_assert(FUTILITY_MARGIN >= 0);
+
+	// Whether the decision computer plays the plies which the position forces (an immediate win, the only block
+	// of a four, or an unblockable double threat) without searching (see ForcedPly)
+	constexpr bool ROOT_TACTICS = true;
+
+	// The threads which answer the decision computer's requests, each with a search of its own
+	constexpr size_t DECISION_WORKERS = 1;			static_assert(DECISION_WORKERS > 0);
+
+	// The best plies the help key (H) logs, with their scores and principal variations, before playing the best one
+	constexpr size_t HINT_LINES = 3;				static_assert(HINT_LINES > 0);
+
+	// The opening book, which the game runs without if it is missing. It is built offline by running
+	// the game with --build-book, and covers the positions with fewer than BOOK_PIECES pieces
+	constexpr const char* OPENING_BOOK_PATH = "openingBook.bin";
+	constexpr size_t BOOK_PIECES = 4;
+	// The depth of the book's searches. They are offline, so they can afford to be deeper
+	constexpr size_t BOOK_PLY_LOOK_AHEAD = PLY_LOOK_AHEAD + 1;	static_assert(BOOK_PLY_LOOK_AHEAD >= PLY_LOOK_AHEAD);
+
+	// The goal function's values are cached in 2^EVALUATION_CACHE_BITS slots of 8 bytes (8 MiB at 20)
+	constexpr size_t EVALUATION_CACHE_BITS = 20;	static_assert(EVALUATION_CACHE_BITS > 0 && EVALUATION_CACHE_BITS <= 32);
+
+	// The search state kept between moves has 2^TRANSPOSITION_TABLE_BITS entries of 16 bytes (4 MiB at 18)
+	constexpr size_t TRANSPOSITION_TABLE_BITS = 18;	static_assert(TRANSPOSITION_TABLE_BITS > 0);
+
+	// The proof-number solver keeps 2^PROOF_TABLE_BITS entries of 24 bytes (6 MiB at 18), split between its threads
+	constexpr size_t PROOF_TABLE_BITS = 18;			static_assert(PROOF_TABLE_BITS >= 4);
+
+	// The engine which decides the computer's plies: the minimax search, or the Monte Carlo tree search
+	enum class Engine { MINIMAX, MONTE_CARLO };
+	constexpr Engine ENGINE = Engine::MINIMAX;
+
+	// The Monte Carlo tree search runs playouts for MCTS_MILLISECONDS per ply, on MCTS_THREADS threads
+	// (0 for one per core), in a tree of at most 2^MCTS_NODE_BITS nodes of 16 bytes (16 MiB at 20)
+	constexpr unsigned MCTS_MILLISECONDS = 2000;	static_assert(MCTS_MILLISECONDS > 0);
+	constexpr size_t MCTS_THREADS = 0;
+	constexpr size_t MCTS_NODE_BITS = 20;			static_assert(MCTS_NODE_BITS > 4 && MCTS_NODE_BITS < 32);
+	// The exploration constant of UCT, and the losses a thread adds to the nodes it descends through,
+	// so that the other threads descend elsewhere until it has played out
+	constexpr float MCTS_EXPLORATION = 1.0f;		static_assert(MCTS_EXPLORATION > 0.0f);
+	constexpr uint32_t MCTS_VIRTUAL_LOSS = 3;		static_assert(MCTS_VIRTUAL_LOSS > 0);
+	// Whether the playouts play the plies forced by the threats on the board (see Board::ThreatPlies) when
+	// there are any, instead of only random in-range plies
+	constexpr bool MCTS_HEURISTIC_PLAYOUTS = true;
+
+	// The computer's game clock: CLOCK_MILLISECONDS for the game, and CLOCK_INCREMENT_MILLISECONDS more after every
+	// ply, or none at 0. Without one, the minimax searches PLY_LOOK_AHEAD plies deep and the Monte Carlo tree search
+	// MCTS_MILLISECONDS long, every ply. With one, every ply is allocated its time (see AllocateTime), and the minimax
+	// deepens iteratively for as long as it allows, up to CLOCK_MAX_DEPTH plies
+	constexpr unsigned CLOCK_MILLISECONDS = 0;
+	constexpr unsigned CLOCK_INCREMENT_MILLISECONDS = 0;
+	constexpr size_t CLOCK_MAX_DEPTH = 8;			static_assert(CLOCK_MAX_DEPTH > 0);
+	// A ply's share of the clock is the time left, less CLOCK_MARGIN_MILLISECONDS, over the plies still expected
+	// (CLOCK_MOVES_TO_GO less those the color has played, and at least CLOCK_MIN_MOVES_TO_GO), plus most of the increment
+	constexpr unsigned CLOCK_MARGIN_MILLISECONDS = 20;
+	constexpr size_t CLOCK_MOVES_TO_GO = 30;
+	constexpr size_t CLOCK_MIN_MOVES_TO_GO = 10;	static_assert(CLOCK_MIN_MOVES_TO_GO > 0 && CLOCK_MIN_MOVES_TO_GO <= CLOCK_MOVES_TO_GO);
+	// The share is scaled by CLOCK_OPENING_FACTOR with fewer than CLOCK_OPENING_PIECES pieces on the board,
+	// by CLOCK_CRITICAL_FACTOR with threats on it, and else by the in-range plies over CLOCK_TYPICAL_CANDIDATES
+	// (between a half and one and a half). The search may go on to CLOCK_MAXIMUM_FACTOR times that, but never
+	// beyond a CLOCK_MAXIMUM_SHARE-th of the time left plus the increment
+	constexpr size_t CLOCK_OPENING_PIECES = 6;
+	constexpr double CLOCK_OPENING_FACTOR = 0.5;
+	constexpr double CLOCK_CRITICAL_FACTOR = 2.0;
+	constexpr size_t CLOCK_TYPICAL_CANDIDATES = 24;	static_assert(CLOCK_TYPICAL_CANDIDATES > 0);
+	constexpr double CLOCK_MAXIMUM_FACTOR = 3.0;	static_assert(CLOCK_MAXIMUM_FACTOR >= 1.0);
+	constexpr size_t CLOCK_MAXIMUM_SHARE = 4;		static_assert(CLOCK_MAXIMUM_SHARE > 0);
+	// Once CLOCK_STABLE_ITERATIONS iterations in a row have kept the best ply, the search begins no iteration after
+	// CLOCK_STABLE_FACTOR times the target; after one which changed it, not until CLOCK_UNSTABLE_FACTOR times it
+	constexpr size_t CLOCK_STABLE_ITERATIONS = 2;
+	constexpr double CLOCK_STABLE_FACTOR = 0.5;
+	constexpr double CLOCK_UNSTABLE_FACTOR = 1.5;
+
+	// The score of a won position (the negation for a lost one). The goal functions' other values lie strictly
+	// between -MAX_HEURISTIC_SCORE and MAX_HEURISTIC_SCORE, which leaves room for a win found d plies before
+	// the search's horizon to score WIN_SCORE + d, and a transposition table to keep it as WIN_SCORE - d,
+	// so that the search prefers the fastest win and the slowest loss. INFINITE_SCORE bounds every score, as a sentinel
+	constexpr Score WIN_SCORE = 30000;
+	constexpr Score MAX_HEURISTIC_SCORE = WIN_SCORE / 2;
+	constexpr Score INFINITE_SCORE = INT16_MAX;	static_assert(WIN_SCORE + BOOK_PLY_LOOK_AHEAD < INFINITE_SCORE &&
+		WIN_SCORE + CLOCK_MAX_DEPTH < INFINITE_SCORE);
+
 	// SCORE_MAP[n - 1] is the term to add to the goal function for a number n pieces in a "five"
-	constexpr float SCORE_MAP[]{
-		1.0f * 1.0f * 1.0f,
-		2.0f * 2.0f * 2.0f,
-		3.0f * 3.0f * 3.0f,
-		4.0f * 4.0f * 4.0f,
-		std::numeric_limits<float>::infinity()
+	// (A won board is scored WIN_SCORE outright, so SCORE_MAP[4] only documents that)
+	constexpr Score SCORE_MAP[]{
+		1 * 1 * 1,
+		2 * 2 * 2,
+		3 * 3 * 3,
+		4 * 4 * 4,
+		WIN_SCORE
 	};
+
+	// The terms the pattern goal function adds on top of SCORE_MAP for an open four (_XXXX_)
+	// and an open three (_XXX__, __XXX_, _XX_X_ or _X_XX_)
+	constexpr Score OPEN_FOUR_SCORE = 1000;
+	constexpr Score OPEN_THREE_SCORE = 100;
 	
 
 
@@ -63,53 +185,386 @@ namespace Constants {
 	constexpr int WINDOW_WIDTH = CELL_PIXEL_WIDTH * BOARD_WIDTH;
 	constexpr int WINDOW_HEIGHT = CELL_PIXEL_WIDTH * BOARD_HEIGHT;
 
-	// Generate "five" "root" arrays at compile time 
+	// Generate "five" "root" arrays at compile time, for any board dimensions
 
+	template <size_t width, size_t height>
 	consteval auto HORIZONTAL_FIVES_GENERATOR() {
-		std::array<size_t, (BOARD_WIDTH - 4) * BOARD_HEIGHT> arr;
+		std::array<size_t, (width - 4) * height> arr;
 		size_t index = 0;
-		for (size_t j = 0; j < BOARD_HEIGHT; ++j) {
-			for (size_t i = 0; i < BOARD_WIDTH - 4; ++i, ++index) {
-				arr[index] = (j * BOARD_WIDTH + i);
+		for (size_t j = 0; j < height; ++j) {
+			for (size_t i = 0; i < width - 4; ++i, ++index) {
+				arr[index] = (j * width + i);
 			}
 		}
 		return arr;
 	}
 
+	template <size_t width, size_t height>
 	consteval auto VERTICAL_FIVES_GENERATOR() {
-		std::array<size_t, BOARD_WIDTH * (BOARD_HEIGHT - 4)> arr;
+		std::array<size_t, width * (height - 4)> arr;
 		for (size_t i = 0; i < arr.size(); ++i) {
 			arr[i] = i;
 		}
 		return arr;
 	}
 
+	template <size_t width, size_t height>
 	consteval auto SOUTHEAST_FIVES_GENERATOR() {
-		std::array<size_t, (BOARD_WIDTH - 4) * (BOARD_HEIGHT - 4)> arr;
+		std::array<size_t, (width - 4) * (height - 4)> arr;
 		size_t index = 0;
-		for (size_t j = 0; j < BOARD_HEIGHT - 4; ++j) {
-			for (size_t i = 0; i < BOARD_WIDTH - 4; ++i, ++index) {
-				arr[index] = (j * BOARD_WIDTH + i);
+		for (size_t j = 0; j < height - 4; ++j) {
+			for (size_t i = 0; i < width - 4; ++i, ++index) {
+				arr[index] = (j * width + i);
 			}
 		}
 		return arr;
 	}
 
+	template <size_t width, size_t height>
 	consteval auto SOUTHWEST_FIVES_GENERATOR() {
-		std::array<size_t, (BOARD_WIDTH - 4) * (BOARD_HEIGHT - 4)> arr;
+		std::array<size_t, (width - 4) * (height - 4)> arr;
 		size_t index = 0;
-		for (size_t j = 0; j < BOARD_HEIGHT - 4; ++j) {
-			for (size_t i = 4; i < BOARD_WIDTH; ++i, ++index) {
-				arr[index] = (j * BOARD_WIDTH + i);
+		for (size_t j = 0; j < height - 4; ++j) {
+			for (size_t i = 4; i < width; ++i, ++index) {
+				arr[index] = (j * width + i);
 			}
 		}
 		return arr;
 	}
 
-	constexpr auto HORIZONTAL_FIVES_ROOTS = HORIZONTAL_FIVES_GENERATOR();
-	constexpr auto VERTICAL_FIVES_ROOTS = VERTICAL_FIVES_GENERATOR();
-	constexpr auto SOUTHEAST_FIVES_ROOTS = SOUTHEAST_FIVES_GENERATOR();
-	constexpr auto SOUTHWEST_FIVES_ROOTS = SOUTHWEST_FIVES_GENERATOR();
+	// Generate "five" incidence tables at compile time, for any board dimensions
+	// Orientations are numbered in the order of FivesOrientation: horizontal, vertical, southeast, southwest
+
+	// A "five" packed into 16 bits: its orientation in the upper 2, the index of its root within
+	// that orientation's roots in the lower 14
+	constexpr uint16_t PackFive(const size_t orientation, const size_t rootIndex) {
+		return static_cast<uint16_t>((orientation << 14) | rootIndex);
+	}
+	constexpr size_t PackedFiveOrientation(const uint16_t five) {
+		return five >> 14;
+	}
+	constexpr size_t PackedFiveRootIndex(const uint16_t five) {
+		return five & 0x3FFF;
+	}
+
+	// FIVES_OFFSETS[o] is the first global index of orientation o's "fives", FIVES_OFFSETS[4] their count
+	template <size_t width, size_t height>
+	consteval auto FIVES_OFFSETS_GENERATOR() {
+		constexpr size_t counts[4] = {
+			HORIZONTAL_FIVES_GENERATOR<width, height>().size(),
+			VERTICAL_FIVES_GENERATOR<width, height>().size(),
+			SOUTHEAST_FIVES_GENERATOR<width, height>().size(),
+			SOUTHWEST_FIVES_GENERATOR<width, height>().size()
+		};
+		std::array<size_t, 5> arr{};
+		for (size_t o = 0; o < 4; ++o) {
+			arr[o + 1] = arr[o] + counts[o];
+		}
+		return arr;
+	}
+
+	// The five cells of every "five", by global index, in the order they appear from the root
+	template <size_t width, size_t height>
+	consteval auto FIVE_CELLS_GENERATOR() {
+		constexpr auto offsets = FIVES_OFFSETS_GENERATOR<width, height>();
+		const auto horizontal = HORIZONTAL_FIVES_GENERATOR<width, height>();
+		const auto vertical = VERTICAL_FIVES_GENERATOR<width, height>();
+		const auto southeast = SOUTHEAST_FIVES_GENERATOR<width, height>();
+		const auto southwest = SOUTHWEST_FIVES_GENERATOR<width, height>();
+		const size_t strides[4] = { 1, width, width + 1, width - 1 };
+
+		std::array<std::array<uint16_t, 5>, offsets[4]> arr{};
+		for (size_t o = 0; o < 4; ++o) {
+			for (size_t r = 0; r < offsets[o + 1] - offsets[o]; ++r) {
+				const size_t root = o == 0 ? horizontal[r] : o == 1 ? vertical[r] : o == 2 ? southeast[r] : southwest[r];
+				for (size_t k = 0; k < 5; ++k) {
+					arr[offsets[o] + r][k] = static_cast<uint16_t>(root + k * strides[o]);
+				}
+			}
+		}
+		return arr;
+	}
+
+	// No cell is part of more than five "fives" per orientation
+	constexpr size_t MAX_CELL_FIVES = 20;
+
+	// The packed "fives" which every cell is part of. Unused entries are zero
+	template <size_t width, size_t height>
+	consteval auto CELL_FIVES_GENERATOR() {
+		constexpr auto offsets = FIVES_OFFSETS_GENERATOR<width, height>();
+		const auto fiveCells = FIVE_CELLS_GENERATOR<width, height>();
+
+		std::array<std::array<uint16_t, MAX_CELL_FIVES>, width * height> arr{};
+		std::array<uint8_t, width * height> counts{};
+		for (size_t o = 0; o < 4; ++o) {
+			for (size_t r = 0; r < offsets[o + 1] - offsets[o]; ++r) {
+				for (const auto cell : fiveCells[offsets[o] + r]) {
+					arr[cell][counts[cell]++] = PackFive(o, r);
+				}
+			}
+		}
+		return arr;
+	}
+
+	// The number of "fives" which every cell is part of
+	template <size_t width, size_t height>
+	consteval auto CELL_FIVES_COUNT_GENERATOR() {
+		const auto fiveCells = FIVE_CELLS_GENERATOR<width, height>();
+
+		std::array<uint8_t, width * height> arr{};
+		for (const auto& five : fiveCells) {
+			for (const auto cell : five) {
+				++arr[cell];
+			}
+		}
+		return arr;
+	}
+
+	// Generate line tables at compile time, for any board dimensions
+	// The lines are the rows, the columns, the southeast diagonals and the southwest diagonals, numbered in that order
+
+	template <size_t width, size_t height>
+	constexpr size_t LINE_COUNT = height + width + 2 * (width + height - 1);
+
+	// The line a cell lies on (for one orientation), and its position along that line
+	struct LinePosition {
+		uint16_t line;
+		uint8_t position;
+	};
+
+	// For every cell, its LinePosition per orientation
+	template <size_t width, size_t height>
+	consteval auto CELL_LINES_GENERATOR() {
+		std::array<std::array<LinePosition, 4>, width * height> arr{};
+		for (size_t y = 0; y < height; ++y) {
+			for (size_t x = 0; x < width; ++x) {
+				auto& lines = arr[y * width + x];
+				lines[0] = { static_cast<uint16_t>(y), static_cast<uint8_t>(x) };
+				lines[1] = { static_cast<uint16_t>(height + x), static_cast<uint8_t>(y) };
+				// Southeast diagonals are indexed by x - y, and start at the top or left edge
+				lines[2] = { static_cast<uint16_t>(height + width + x + (height - 1) - y),
+					static_cast<uint8_t>(x < y ? x : y) };
+				// Southwest diagonals are indexed by x + y, and start at the top or right edge
+				const size_t top = x + y > width - 1 ? x + y - (width - 1) : 0;
+				lines[3] = { static_cast<uint16_t>(height + width + (width + height - 1) + x + y),
+					static_cast<uint8_t>(y - top) };
+			}
+		}
+		return arr;
+	}
+
+	// The number of cells on every line
+	template <size_t width, size_t height>
+	consteval auto LINE_LENGTHS_GENERATOR() {
+		const auto cellLines = CELL_LINES_GENERATOR<width, height>();
+		std::array<uint8_t, LINE_COUNT<width, height>> arr{};
+		for (const auto& lines : cellLines) {
+			for (const auto& line : lines) {
+				++arr[line.line];
+			}
+		}
+		return arr;
+	}
+
+	// The cells of every line, by position along it
+	template <size_t width, size_t height>
+	consteval auto LINE_CELLS_GENERATOR() {
+		const auto cellLines = CELL_LINES_GENERATOR<width, height>();
+		std::array<std::array<uint16_t, (width > height ? width : height)>, LINE_COUNT<width, height>> arr{};
+		for (size_t cell = 0; cell < width * height; ++cell) {
+			for (const auto& line : cellLines[cell]) {
+				arr[line.line][line.position] = static_cast<uint16_t>(cell);
+			}
+		}
+		return arr;
+	}
+
+	// Generate the pattern table at compile time
+	// A six-cell window of a line is indexed by two 6-bit masks, red in the lower bits and blue in the upper,
+	// where a cell beyond the end of the line (a wall) has both bits set
+
+	struct PatternEntry {
+		// The finite score of the window, red positive
+		Score score;
+		// +1 if the first five cells of the window are all red, -1 if all blue, else 0
+		int8_t five;
+		// Whether the first five cells of the window are free of blue (bit 0) and of red (bit 1),
+		// i.e. whether red or blue could still complete them
+		uint8_t live;
+	};
+
+	consteval auto PATTERN_GENERATOR() {
+		enum class Cell { EMPTY, RED, BLUE, WALL };
+
+		// Does the window match the pattern, where 'X' is the color and '_' is empty?
+		auto matches = [](const Cell* window, const char* pattern, const Cell color) {
+			for (size_t i = 0; i < 6; ++i) {
+				if ((pattern[i] == 'X' && window[i] != color) || (pattern[i] == '_' && window[i] != Cell::EMPTY))
+					return false;
+			}
+			return true;
+		};
+
+		// Scores the window for the color. Only the first five cells are scored as a "five", so that
+		// sliding the window along a line scores every "five" exactly once
+		auto score = [&](const Cell* window, const Cell color, int8_t& five) -> Score {
+			size_t count = 0;
+			for (size_t i = 0; i < 5; ++i) {
+				if (window[i] == color) ++count;
+				else if (window[i] != Cell::EMPTY) {
+					count = 0;
+					break;
+				}
+			}
+			if (count == 5) {
+				five = 1;
+				return 0;
+			}
+			Score sum = count ? SCORE_MAP[count - 1] : 0;
+			if (matches(window, "_XXXX_", color)) sum += OPEN_FOUR_SCORE;
+			for (const auto pattern : { "_XXX__", "__XXX_", "_XX_X_", "_X_XX_" }) {
+				if (matches(window, pattern, color)) sum += OPEN_THREE_SCORE;
+			}
+			return sum;
+		};
+
+		std::array<PatternEntry, 1 << 12> arr{};
+		for (size_t index = 0; index < arr.size(); ++index) {
+			Cell window[6];
+			for (size_t i = 0; i < 6; ++i) {
+				const bool red = index & (1 << i);
+				const bool blue = index & (1 << (i + 6));
+				window[i] = red ? (blue ? Cell::WALL : Cell::RED) : (blue ? Cell::BLUE : Cell::EMPTY);
+			}
+			int8_t redFive{}, blueFive{};
+			arr[index].score = score(window, Cell::RED, redFive) - score(window, Cell::BLUE, blueFive);
+			arr[index].five = redFive - blueFive;
+			bool redLive = true, blueLive = true;
+			for (size_t i = 0; i < 5; ++i) {
+				redLive &= window[i] == Cell::EMPTY || window[i] == Cell::RED;
+				blueLive &= window[i] == Cell::EMPTY || window[i] == Cell::BLUE;
+			}
+			arr[index].live = static_cast<uint8_t>(redLive | blueLive << 1);
+		}
+		return arr;
+	}
+
+	constexpr auto PATTERN_TABLE = PATTERN_GENERATOR();
+
+	// Generate symmetry and Zobrist tables at compile time, for any board dimensions
+	// Symmetries 0-3 (identity, horizontal mirror, vertical mirror, half turn) apply to every board,
+	// 4-7 (transpose, quarter turn, three-quarter turn, anti-transpose) only to square ones
+
+	template <size_t width, size_t height>
+	constexpr size_t SYMMETRY_COUNT = width == height ? 8 : 4;
+
+	// The symmetry which undoes symmetry s
+	constexpr uint8_t INVERSE_SYMMETRY[8] = { 0, 1, 2, 3, 4, 6, 5, 7 };
+
+	// SYMMETRY_CELLS[s][pos] is the cell which pos is mapped to by symmetry s
+	template <size_t width, size_t height>
+	consteval auto SYMMETRY_CELLS_GENERATOR() {
+		std::array<std::array<uint16_t, width * height>, SYMMETRY_COUNT<width, height>> arr{};
+		for (size_t s = 0; s < arr.size(); ++s) {
+			for (size_t y = 0; y < height; ++y) {
+				for (size_t x = 0; x < width; ++x) {
+					const size_t mx = width - 1 - x, my = height - 1 - y;
+					size_t to{};
+					switch (s) {
+					case 0: to = y * width + x; break;
+					case 1: to = y * width + mx; break;
+					case 2: to = my * width + x; break;
+					case 3: to = my * width + mx; break;
+					case 4: to = x * width + y; break;
+					case 5: to = x * width + my; break;
+					case 6: to = mx * width + y; break;
+					default: to = mx * width + my; break;
+					}
+					arr[s][y * width + x] = static_cast<uint16_t>(to);
+				}
+			}
+		}
+		return arr;
+	}
+
+	// ZOBRIST_KEYS[pos][color][s] is the key of a piece of the color (0 red, 1 blue) at the cell which
+	// pos is mapped to by symmetry s. Keeping a cell's keys together makes a move touch one cache line per color
+	template <size_t width, size_t height>
+	consteval auto ZOBRIST_KEYS_GENERATOR() {
+		// SplitMix64, seeded by the dimensions so that different board sizes never share keys
+		uint64_t state = width * 1000 + height;
+		auto next = [&]() {
+			uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		};
+		std::array<std::array<uint64_t, width * height>, 2> keys{};
+		for (auto& color : keys) {
+			for (auto& key : color) key = next();
+		}
+
+		constexpr size_t symmetries = SYMMETRY_COUNT<width, height>;
+		const auto cells = SYMMETRY_CELLS_GENERATOR<width, height>();
+		std::array<std::array<std::array<uint64_t, symmetries>, 2>, width * height> arr{};
+		for (size_t pos = 0; pos < width * height; ++pos) {
+			for (size_t color = 0; color < 2; ++color) {
+				for (size_t s = 0; s < symmetries; ++s) {
+					arr[pos][color][s] = keys[color][cells[s][pos]];
+				}
+			}
+		}
+		return arr;
+	}
+
+	// The compile-time constants of a board of the given dimensions
+
+	template <size_t width, size_t height>
+	struct BoardGeometry {
+		static_assert(width >= 5 && height >= 5);
+
+		static constexpr size_t WIDTH = width;
+		static constexpr size_t HEIGHT = height;
+		static constexpr size_t SIZE = width * height;
+
+		static constexpr auto HORIZONTAL_FIVES_ROOTS = HORIZONTAL_FIVES_GENERATOR<width, height>();
+		static constexpr auto VERTICAL_FIVES_ROOTS = VERTICAL_FIVES_GENERATOR<width, height>();
+		static constexpr auto SOUTHEAST_FIVES_ROOTS = SOUTHEAST_FIVES_GENERATOR<width, height>();
+		static constexpr auto SOUTHWEST_FIVES_ROOTS = SOUTHWEST_FIVES_GENERATOR<width, height>();
+
+		// Incidence tables, for local work around a cell without any stride arithmetic
+		// FIVE_CELLS is indexed by global "five" index (see FiveIndex), CELL_FIVES and CELL_FIVES_COUNT by cell
+		// Footprint (INCIDENCE_FOOTPRINT): 14945 bytes for 15x15 (572 "fives"), 25001 bytes for 19x19 (1020 "fives")
+		static constexpr auto FIVES_OFFSETS = FIVES_OFFSETS_GENERATOR<width, height>();
+		static constexpr size_t FIVES_COUNT = FIVES_OFFSETS[4];
+		static constexpr auto FIVE_CELLS = FIVE_CELLS_GENERATOR<width, height>();
+		static constexpr auto CELL_FIVES = CELL_FIVES_GENERATOR<width, height>();
+		static constexpr auto CELL_FIVES_COUNT = CELL_FIVES_COUNT_GENERATOR<width, height>();
+		static constexpr size_t INCIDENCE_FOOTPRINT = sizeof(FIVE_CELLS) + sizeof(CELL_FIVES) + sizeof(CELL_FIVES_COUNT);
+
+		// Line tables, for the pattern evaluation and the threat search
+		static constexpr size_t LINE_COUNT = Constants::LINE_COUNT<width, height>;
+		static constexpr auto CELL_LINES = CELL_LINES_GENERATOR<width, height>();
+		static constexpr auto LINE_LENGTHS = LINE_LENGTHS_GENERATOR<width, height>();
+		static constexpr auto LINE_CELLS = LINE_CELLS_GENERATOR<width, height>();
+
+		// Symmetry tables, for the symmetry-canonical position keys
+		static constexpr size_t SYMMETRY_COUNT = Constants::SYMMETRY_COUNT<width, height>;
+		static constexpr auto SYMMETRY_CELLS = SYMMETRY_CELLS_GENERATOR<width, height>();
+		static constexpr auto ZOBRIST_KEYS = ZOBRIST_KEYS_GENERATOR<width, height>();
+
+		// Returns the global index of a packed "five"
+		static constexpr size_t FiveIndex(const uint16_t five) {
+			return FIVES_OFFSETS[PackedFiveOrientation(five)] + PackedFiveRootIndex(five);
+		}
+	};
+
+	// The "five" "root" arrays of the configured board
+
+	constexpr auto HORIZONTAL_FIVES_ROOTS = BoardGeometry<BOARD_WIDTH, BOARD_HEIGHT>::HORIZONTAL_FIVES_ROOTS;
+	constexpr auto VERTICAL_FIVES_ROOTS = BoardGeometry<BOARD_WIDTH, BOARD_HEIGHT>::VERTICAL_FIVES_ROOTS;
+	constexpr auto SOUTHEAST_FIVES_ROOTS = BoardGeometry<BOARD_WIDTH, BOARD_HEIGHT>::SOUTHEAST_FIVES_ROOTS;
+	constexpr auto SOUTHWEST_FIVES_ROOTS = BoardGeometry<BOARD_WIDTH, BOARD_HEIGHT>::SOUTHWEST_FIVES_ROOTS;
 
 	// UNIVERSAL CONSTANTS
 
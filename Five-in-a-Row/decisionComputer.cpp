@@ -1,70 +1,304 @@
 #include "decisionComputer.hpp"
 #include "goalFunction.hpp"
 
-DecisionComputer::DecisionComputer() {
-
-	// Run the thread
-	thread = std::thread([&]() {
-		constexpr Minimax<Constants::PLY_LOOK_AHEAD, true, GoalFunction, true> redComputer;
-		constexpr Minimax<Constants::PLY_LOOK_AHEAD, false, GoalFunction, true> blueComputer;
-		while (true) {
-			
-			// Await the begin signal
-			begin.acquire();
-			
-			// Is the signal from the destructor?
-			if (dead)
-				return;
-
-			// Call minimax
-			result = blue ? blueComputer(*board) : redComputer(*board);
-
-			// Signal completion
-			complete.release();
+#include <variant>
+#include <chrono>
+#include <type_traits>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+// Runs the minimax with the goal function, returning the best ply for the color
+// The search tries the line it was expected to follow first
+template <typename BoardType, Score(*F)(const BoardType&)>
+size_t Decide(const BoardType& board, const bool blue, const std::vector<size_t>& expected, SearchContext& context,
+	SearchProgress* progress) {
+	FollowVariation(board, !blue, expected, context);
+	constexpr BasicMinimax<BoardType, Constants::PLY_LOOK_AHEAD, true, F, true> redComputer;
+	constexpr BasicMinimax<BoardType, Constants::PLY_LOOK_AHEAD, false, F, true> blueComputer;
+	constexpr auto infinity = Constants::INFINITE_SCORE;
+	return blue ? blueComputer(board, -infinity, infinity, &context, progress) :
+		redComputer(board, -infinity, infinity, &context, progress);
+}
+
+// Runs the minimax with the goal function, deepening it for as long as the allocation allows
+template <typename BoardType, Score(*F)(const BoardType&)>
+DeepeningResult DecideInTime(const BoardType& board, const bool blue, const std::vector<size_t>& expected,
+	SearchContext& context, SearchProgress* progress, const TimeAllocation& allocation) {
+	FollowVariation(board, !blue, expected, context);
+	constexpr BasicIterativeDeepening<BoardType, Constants::CLOCK_MAX_DEPTH, true, F> redComputer;
+	constexpr BasicIterativeDeepening<BoardType, Constants::CLOCK_MAX_DEPTH, false, F> blueComputer;
+	return blue ? blueComputer(board, allocation, &context, progress) : redComputer(board, allocation, &context, progress);
+}
+
+// Runs the multi-PV minimax with the goal function, returning the lines best plies for the color
+template <typename BoardType, Score(*F)(const BoardType&)>
+std::vector<ScoredPly> AnalyzeLines(const BoardType& board, const bool blue, const size_t lines, SearchContext& context,
+	SearchProgress* progress) {
+	constexpr BasicMultiPV<BoardType, Constants::PLY_LOOK_AHEAD, true, F> redAnalysis;
+	constexpr BasicMultiPV<BoardType, Constants::PLY_LOOK_AHEAD, false, F> blueAnalysis;
+	return blue ? blueAnalysis(board, lines, &context, progress) : redAnalysis(board, lines, &context, progress);
+}
+
+// Returns the rest of the variation of the ancestor's search, for the color, if the board has followed it so far
+std::vector<size_t> RemainingVariation(const AnyBoard& ancestor, const bool blue, const std::vector<size_t>& variation,
+	const AnyBoard& board) {
+	return std::visit([&](auto ancestor, const auto& board) -> std::vector<size_t> {
+		if constexpr (!std::is_same_v<decltype(ancestor), std::remove_cvref_t<decltype(board)>>) {
+			return {};
 		}
-	});
+		else {
+			auto color = blue;
+			for (auto ply = variation.begin(); ply != variation.end(); ++ply) {
+				if (ancestor.Key() == board.Key()) {
+					return { ply, variation.end() };
+				}
+				if (board.At(*ply) != (color ? CellState::BLUE : CellState::RED)) {
+					return {};
+				}
+				ancestor = ancestor.Play(*ply, color);
+				color = !color;
+			}
+			return {};
+		}
+	}, ancestor, board);
+}
+
+// Returns whether the board has every piece of the ancestor (and is of the same size)
+bool IsDescendant(const AnyBoard& ancestor, const AnyBoard& board) {
+	return std::visit([](const auto& ancestor, const auto& board) {
+		if constexpr (!std::is_same_v<decltype(ancestor), decltype(board)>) {
+			return false;
+		}
+		else {
+			for (size_t pos = 0; pos < ancestor.SIZE; ++pos) {
+				if (ancestor.At(pos) != CellState::EMPTY && ancestor.At(pos) != board.At(pos)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}, ancestor, board);
+}
+
+DecisionComputer::DecisionComputer(const Constants::Engine engine, const size_t workers,
+	std::function<void()> answered) :
+	answered(std::move(answered)), book(Constants::OPENING_BOOK_PATH) {
+
+	// Select the fastest way to evaluate the goal function on this machine, before any search uses it
+	GoalFunctionThreadPool::Calibrate();
+
+	// A single worker uses the thread pool, unless another computer has it
+	pooled = workers <= 1 && GoalFunctionThreadPool::Claim();
+
+	// Run the workers
+	for (size_t i = 0; i < std::max<size_t>(workers, 1); ++i) {
+		auto& worker = *this->workers.emplace_back(std::make_unique<Worker>());
+		if (engine == Constants::Engine::MONTE_CARLO) {
+			worker.monteCarlo.emplace();
+		}
+		threads.emplace_back([this, &worker]() { Serve(worker); });
+	}
 }
 
 DecisionComputer::~DecisionComputer() {
-	dead = true;
-	
-	// Awake the thread
-	begin.release();
+	{
+		std::lock_guard lock(mutex);
+		dead = true;
+	}
 
-	// Await it
-	thread.join();
+	// Awake the workers, and await them
+	available.notify_all();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	if (pooled) {
+		GoalFunctionThreadPool::Release();
+	}
 }
 
-void DecisionComputer::operator()(const Board& board, const bool blue) {
-	// No data races
-	if (running) {
-		Await();
+std::future<Decision> DecisionComputer::Submit(const AnyBoard& board, const bool blue, const int priority,
+	const size_t lines, std::shared_ptr<SearchProgress> progress, const std::optional<GameClock> clock, const uint64_t game) {
+	if (std::visit([](const auto& board) { return board.Full(); }, board)) {
+		throw std::invalid_argument("Could not decide a ply: the board is full.");
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	std::promise<Decision> promise;
+	auto future = promise.get_future();
+
+	// Is the answer in the book?
+	if (!lines) {
+		if (const auto ply = std::visit([&](const auto& board) { return book.Lookup(board, blue); }, board)) {
+			promise.set_value({ *ply, { std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+				0.0, true, false, {}, 0, { *ply }, 0.0, 0, Tactic::NONE }, {} });
+			if (answered) {
+				answered();
+			}
+			return future;
+		}
+
+		// Is the ply forced?
+		if constexpr (Constants::ROOT_TACTICS) {
+			const auto forced = std::visit([&](const auto& board) { return ForcedPly(board, blue); }, board);
+			const auto now = std::chrono::steady_clock::now();
+			++tacticChecks;
+			tacticNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+			if (forced) {
+				++tacticHits[static_cast<size_t>(forced->tactic)];
+				promise.set_value({ forced->ply, { std::chrono::duration<double, std::milli>(now - start).count(),
+					0.0, false, false, {}, 0, { forced->ply }, 0.0, 0, forced->tactic }, {} });
+				if (answered) {
+					answered();
+				}
+				return future;
+			}
+		}
+	}
+
+	// Queue it, and awake a worker
+	{
+		std::lock_guard lock(mutex);
+		queue.push_back({ priority, sequence++, board, blue, lines, start, std::move(progress), clock, game, 0,
+			std::move(promise) });
+		std::push_heap(queue.begin(), queue.end(), Later);
 	}
-	this->board = &board;
-	this->blue = blue;
-	running = true;
+	available.notify_one();
+	return future;
+}
+
+size_t DecisionComputer::Queued() const {
+	std::lock_guard lock(mutex);
+	return queue.size();
+}
+
+TacticStatistics DecisionComputer::Tactics() const {
+	return { tacticChecks, tacticHits[static_cast<size_t>(Tactic::WIN)], tacticHits[static_cast<size_t>(Tactic::BLOCK)],
+		tacticHits[static_cast<size_t>(Tactic::DOUBLE_THREAT)], tacticNanoseconds / 1e6 };
+}
 
-	// Awake the thread
-	begin.release();
+void DecisionComputer::Invalidate(const uint64_t game) {
+	std::lock_guard lock(mutex);
+	++generations[game];
 }
 
-bool DecisionComputer::Running() const {
-	return running;
+bool DecisionComputer::Later(const Request& lhs, const Request& rhs) {
+	return lhs.priority < rhs.priority || (lhs.priority == rhs.priority && lhs.sequence > rhs.sequence);
 }
 
-std::optional<size_t> DecisionComputer::TryResult() noexcept {
-	// Non-blocking acquire attempt
-	if (complete.try_acquire()) {
-		// It's done! Return the result
-		running = false;
-		return result;
+void DecisionComputer::Serve(Worker& worker) {
+	while (true) {
+		// Await a request, or the destructor
+		std::unique_lock lock(mutex);
+		available.wait(lock, [&]() { return dead || !queue.empty(); });
+		if (dead)
+			return;
+		std::pop_heap(queue.begin(), queue.end(), Later);
+		auto request = std::move(queue.back());
+		queue.pop_back();
+		request.generation = generations[request.game];
+		lock.unlock();
+
+		try {
+			request.promise.set_value(Answer(worker, request));
+		}
+		catch (...) {
+			request.promise.set_exception(std::current_exception());
+		}
+		if (answered) {
+			answered();
+		}
 	}
-	// It's still running, return the null-opt
-	return {};
 }
 
-void DecisionComputer::Await() noexcept {
-	// Block until the thread signals completion
-	complete.acquire();
-	running = false;
+Decision DecisionComputer::Answer(Worker& worker, const Request& request) {
+	const auto start = std::chrono::steady_clock::now();
+	const double queued = std::chrono::duration<double, std::milli>(start - request.submitted).count();
+	const auto& board = request.board;
+	const bool blue = request.blue;
+	const auto progress = request.progress.get();
+
+	// Forget the state of another game, or of this game if it has been invalidated since
+	if (worker.game != request.game || worker.generation != request.generation) {
+		worker.game = request.game;
+		worker.generation = request.generation;
+		worker.previous.reset();
+		worker.previousVariation.clear();
+		worker.context.Clear();
+		if (worker.monteCarlo) {
+			worker.monteCarlo->Clear();
+		}
+	}
+
+	// The time of a decision on the clock
+	std::optional<TimeAllocation> allocation;
+	if (request.clock && !request.lines) {
+		allocation = std::visit([&](const auto& board) { return AllocateTime(board, blue, *request.clock); }, board);
+	}
+	const double allocated = allocation ? std::chrono::duration<double, std::milli>(allocation->target).count() : 0.0;
+
+	// Search the tree, which keeps what it can of the previous search itself
+	if (worker.monteCarlo && !request.lines) {
+		const MonteCarloBudget budget{ std::numeric_limits<uint64_t>::max(), allocation ?
+			std::max(allocation->target, std::chrono::milliseconds(1)) : std::chrono::milliseconds(Constants::MCTS_MILLISECONDS) };
+		const auto found = std::visit([&](const auto& board) { return worker.monteCarlo->Search(board, blue, budget, Constants::MCTS_THREADS, progress); }, board);
+		return { found.ply, { found.milliseconds, queued, false, found.recycled > 0, {}, found.playouts, {}, allocated, 0,
+			Tactic::NONE },
+			{} };
+	}
+
+	// Keep the search state if this board follows from the previous one
+	auto& context = worker.context;
+	const bool reused = worker.previous && IsDescendant(*worker.previous, board);
+	if (!reused) {
+		context.Clear();
+	}
+	const auto before = context.Statistics();
+
+	// Call minimax, on the line the previous search expected if the game has followed it
+	Decision decision{};
+	if (request.lines) {
+		decision.analysis = std::visit([&](const auto& board) {
+			using BoardType = std::remove_cvref_t<decltype(board)>;
+			return pooled ? AnalyzeLines<BoardType, GoalFunction>(board, blue, request.lines, context, progress) :
+				AnalyzeLines<BoardType, InlineGoalFunction>(board, blue, request.lines, context, progress);
+		}, board);
+		decision.ply = decision.analysis.front().ply;
+		decision.report.variation = decision.analysis.front().variation;
+		decision.report.depth = Constants::PLY_LOOK_AHEAD;
+	}
+	else {
+		const auto expected = reused ?
+			RemainingVariation(*worker.previous, worker.previousBlue, worker.previousVariation, board) : std::vector<size_t>{};
+		if (allocation) {
+			const auto found = std::visit([&](const auto& board) {
+				using BoardType = std::remove_cvref_t<decltype(board)>;
+				return pooled ? DecideInTime<BoardType, GoalFunction>(board, blue, expected, context, progress, *allocation) :
+					DecideInTime<BoardType, InlineGoalFunction>(board, blue, expected, context, progress, *allocation);
+			}, board);
+			decision.ply = found.ply;
+			decision.report.depth = found.depth;
+			decision.report.variation = found.variation;
+		}
+		else {
+			decision.ply = std::visit([&](const auto& board) {
+				using BoardType = std::remove_cvref_t<decltype(board)>;
+				return pooled ? Decide<BoardType, GoalFunction>(board, blue, expected, context, progress) :
+					Decide<BoardType, InlineGoalFunction>(board, blue, expected, context, progress);
+			}, board);
+			decision.report.depth = Constants::PLY_LOOK_AHEAD;
+			decision.report.variation = context.Variation(decision.report.depth);
+		}
+	}
+
+	const auto& after = context.Statistics();
+	decision.report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	decision.report.queuedMilliseconds = queued;
+	decision.report.allocatedMilliseconds = allocated;
+	decision.report.reused = reused;
+	decision.report.statistics = { after.probes - before.probes, after.hits - before.hits, after.cutoffs - before.cutoffs };
+	worker.previous = board;
+	worker.previousBlue = blue;
+	worker.previousVariation = decision.report.variation;
+	return decision;
 }
\ No newline at end of file
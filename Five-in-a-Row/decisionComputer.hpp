@@ -1,46 +1,178 @@
-// This header defines the DecisionComputer class, which runs the minimax algorithm on a thread
-// It also has the responsibility of killing the goal function thread pool.
+// This header defines the DecisionComputer class, which runs the minimax algorithm (or the Monte Carlo
+// tree search, see Constants::ENGINE) on a set of worker threads
+// A request copies the board in, and is answered through a future, so the caller never waits on it unless it
+// wants to. Requests wait in a queue, which serves the highest priority first (and equal priorities in order),
+// so several games can share a few workers. The board's size is dispatched at runtime to the minimax of that size
+// Positions in the opening book, and positions which force the ply (see ForcedPly), are answered right away,
+// without queueing
+// A request may come with a SearchProgress, to which the search publishes its best ply so far as it goes, and with
+// the color's game clock, which the search's time is allocated from (see AllocateTime) instead of searching as deep
+// (or as long) as configured
+// Every worker keeps its search state (see SearchContext) between searches, as long as every search's board is
+// a descendant of its previous one's, of the same game. It must be invalidated when the game goes back or restarts,
+// which only forgets the state of that game
+// The goal function's thread pool can only serve one search at a time (see GoalFunctionThreadPool::Claim), so only
+// a computer with one worker uses it, and only if no other computer does. Every other search evaluates inline
 
 #pragma once
 
 #include "constants.hpp"
 #include "goalFunctionThreadPool.hpp"
 #include "minimax.hpp"
+#include "openingBook.hpp"
+#include "searchContext.hpp"
+#include "monteCarlo.hpp"
+#include "searchProgress.hpp"
+#include "gameClock.hpp"
+#include "rootTactics.hpp"
 
 #include <thread>
 #include <optional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+// What a decision took, and what it reused
+struct SearchReport {
+	// The wall time of the decision, and the time it waited in the queue before that
+	double milliseconds;
+	double queuedMilliseconds;
+	// Whether it was answered by the opening book
+	bool book;
+	// Whether the search reused the state of the previous one
+	bool reused;
+	// The transposition table counters of the search
+	SearchStatistics statistics;
+	// The playouts of a Monte Carlo search
+	uint64_t playouts;
+	// The principal variation: the ply, and the best replies the search expects
+	std::vector<size_t> variation;
+	// The time allocated to the decision by its game clock (0 without one), and the depth the minimax searched
+	double allocatedMilliseconds;
+	size_t depth;
+	// The tactic which forced the ply, if no search was needed
+	Tactic tactic;
+};
+
+// The decisions which the root tactics answered, of those they were checked for, and the time the checks took
+struct TacticStatistics {
+	uint64_t checks;
+	uint64_t wins;
+	uint64_t blocks;
+	uint64_t doubleThreats;
+	double milliseconds;
+};
+
+// The answer to a request
+struct Decision {
+	size_t ply;
+	SearchReport report;
+	// The lines of an analysis, best first (none for a decision)
+	std::vector<ScoredPly> analysis;
+};
 
 class DecisionComputer {
 public:
-	DecisionComputer();
+	// A computer with workers worker threads. With more than one, or when another computer has claimed the thread pool,
+	// the searches evaluate the goal function on their own threads (see InlineGoalFunction) instead of using the pool.
+	// answered, if any, is called whenever a future becomes ready, on the thread which made it so (e.g. to wake
+	// a thread which sleeps instead of polling the futures)
+	explicit DecisionComputer(const Constants::Engine engine = Constants::ENGINE,
+		const size_t workers = Constants::DECISION_WORKERS, std::function<void()> answered = {});
+
+	// Abandons the queued requests (their futures throw std::future_error), waits for the running ones,
+	// and releases the thread pool, if it has it
 	~DecisionComputer();
 
-	// Signals the thread to begin the search, given the board and color of the ply
-	void operator()(const Board& board, const bool blue);
+	// Queues a decision of the ply for the color on the board (of any instantiated size).
+	// With lines, it is an analysis instead: a minimax search for its lines best plies (see BasicMultiPV),
+	// whatever the engine, and without the opening book. The ply is the best of them.
+	// The search publishes its progress to progress, if any, which the caller may read meanwhile.
+	// A decision on the clock takes the time allocated from it (an analysis ignores it).
+	// Requests of several games sharing the computer should each give their own game.
+	// A full board has no ply to decide, and throws std::invalid_argument
+	std::future<Decision> Submit(const AnyBoard& board, const bool blue, const int priority = 0,
+		const size_t lines = 0, std::shared_ptr<SearchProgress> progress = {}, const std::optional<GameClock> clock = {},
+		const uint64_t game = 0);
 
-	// Returns whether the search is running
-	bool Running() const;
+	// Returns the number of requests waiting for a worker
+	size_t Queued() const;
 
-	// Returns the result of the search, if available. Does not block
-	std::optional<size_t> TryResult() noexcept;
+	// Returns the root tactics' hits so far
+	TacticStatistics Tactics() const;
 
-	// Block until the search is complete
-	void Await() noexcept;
+	// Discards the search state kept between the searches of the game, before every worker's next request of it.
+	// Call it when pieces are removed from the game's board, i.e. on undo and reset
+	void Invalidate(const uint64_t game = 0);
 
 private:
-	bool running{};
-	class ThreadPoolKiller {
-	public:
-		~ThreadPoolKiller() {
-			GoalFunctionThreadPool::Kill();
-		}
-	} killer;
-	std::thread thread;
-	std::binary_semaphore begin{ 0 };
-	std::binary_semaphore complete{ 0 };
+	struct Request {
+		int priority;
+		// The order of submission, which breaks ties in priority
+		uint64_t sequence;
+		AnyBoard board;
+		bool blue;
+		// The lines to analyze, or 0 for a decision
+		size_t lines;
+		std::chrono::steady_clock::time_point submitted;
+		std::shared_ptr<SearchProgress> progress;
+		std::optional<GameClock> clock;
+		// The game, and its invalidations when the request was taken from the queue
+		uint64_t game;
+		uint64_t generation;
+		std::promise<Decision> promise;
+	};
+
+	// The state a worker keeps between its searches
+	struct Worker {
+		SearchContext context;
+		// The tree of the Monte Carlo search, which decides instead of the minimax if there is one
+		std::optional<MonteCarlo> monteCarlo;
+		// The board of the previous search, whose descendants may reuse the context, its color to move and
+		// its principal variation, which the next search tries first as long as the game follows it
+		std::optional<AnyBoard> previous;
+		bool previousBlue{};
+		std::vector<size_t> previousVariation;
+		// The game of the state, and the invalidations of it the state has seen
+		uint64_t game{};
+		uint64_t generation{};
+	};
+
+	// Whether the request is served after the other
+	static bool Later(const Request& lhs, const Request& rhs);
+
+	// Answers the requests of the queue on the worker, until the destructor
+	void Serve(Worker& worker);
+
+	// Answers the request on the worker
+	Decision Answer(Worker& worker, const Request& request);
+
+	// The requests, a heap by priority and sequence
+	std::vector<Request> queue;
+	mutable std::mutex mutex;
+	std::condition_variable available;
+	uint64_t sequence{};
 	bool dead{};
-	
-	size_t result;
-	const Board* board;
-	bool blue;
+
+	// The invalidations of every game, by Invalidate
+	std::unordered_map<uint64_t, uint64_t> generations;
+	// Whether the searches use the thread pool, which the computer has claimed
+	bool pooled{};
+	std::function<void()> answered;
+
+	OpeningBook book;
+
+	// The root tactics' checks, hits (by Tactic) and time
+	std::atomic<uint64_t> tacticChecks{};
+	std::array<std::atomic<uint64_t>, 4> tacticHits{};
+	std::atomic<uint64_t> tacticNanoseconds{};
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
 };
\ No newline at end of file
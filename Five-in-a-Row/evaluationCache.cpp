@@ -0,0 +1,45 @@
+#include "evaluationCache.hpp"
+
+#include <algorithm>
+
+EvaluationCache EvaluationCache::instance;
+
+EvaluationCache& EvaluationCache::Get() {
+	return instance;
+}
+
+EvaluationCache::EvaluationCache() : slots(std::make_unique<std::atomic<uint64_t>[]>(SLOT_COUNT)) {}
+
+EvaluationCache::ThreadCounters::ThreadCounters() {
+	std::lock_guard lock(instance.mutex);
+	instance.threads.push_back(this);
+}
+
+EvaluationCache::ThreadCounters::~ThreadCounters() {
+	std::lock_guard lock(instance.mutex);
+	instance.exited.hits += hits.load(std::memory_order_relaxed);
+	instance.exited.misses += misses.load(std::memory_order_relaxed);
+	std::erase(instance.threads, this);
+}
+
+void EvaluationCache::Clear() {
+	for (size_t i = 0; i < SLOT_COUNT; ++i) {
+		slots[i].store(0, std::memory_order_relaxed);
+	}
+	std::lock_guard lock(mutex);
+	for (const auto counters : threads) {
+		counters->hits.store(0, std::memory_order_relaxed);
+		counters->misses.store(0, std::memory_order_relaxed);
+	}
+	exited = {};
+}
+
+EvaluationCacheStatistics EvaluationCache::Statistics() const {
+	std::lock_guard lock(mutex);
+	auto statistics = exited;
+	for (const auto counters : threads) {
+		statistics.hits += counters->hits.load(std::memory_order_relaxed);
+		statistics.misses += counters->misses.load(std::memory_order_relaxed);
+	}
+	return statistics;
+}
\ No newline at end of file
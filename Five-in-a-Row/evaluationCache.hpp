@@ -0,0 +1,117 @@
+// This header defines the evaluation cache, a fixed-size direct-mapped table of goal function values keyed by
+// the board's Zobrist key (see Board::Key), which GoalFunction consults before waking the thread pool.
+// Sibling subtrees of Minimax, and its sorting comparators, evaluate the same positions many times over.
+// It is a singleton, like the thread pool, so that it can be used statically.
+
+// Every slot is a single 64-bit atomic holding the upper 48 bits of the key and the 16-bit value, so concurrent
+// searches share the cache without locks and never read a torn entry. The lower bits of the key select the slot,
+// so a false hit takes two keys agreeing on both the slot and the upper 48 bits. New values always replace old ones.
+// The hits and misses are counted per thread, and only summed by Statistics, so lookups share no counter either
+
+#pragma once
+
+#include "constants.hpp"
+
+#include <atomic>
+#include <optional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+// The counters of EvaluationCache
+struct EvaluationCacheStatistics {
+	uint64_t hits;
+	uint64_t misses;
+
+	// Returns the share of lookups which were hits, or 0 if there were none
+	double HitRate() const {
+		return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+	}
+};
+
+class EvaluationCache {
+public:
+	// The number of slots, and the bytes they take up
+	static constexpr size_t SLOT_COUNT = size_t{ 1 } << Constants::EVALUATION_CACHE_BITS;
+	static constexpr size_t FOOTPRINT = SLOT_COUNT * sizeof(std::atomic<uint64_t>);
+
+	// Returns a reference to the instance
+	static EvaluationCache& Get();
+
+	// Returns the cached value of the board with the key, if any
+	std::optional<Score> Find(const uint64_t key);
+
+	// Caches the value of the board with the key, replacing whatever was in its slot
+	void Store(const uint64_t key, const Score value);
+
+	// Empties the cache and resets its counters. Must not be called while the cache is in use elsewhere
+	void Clear();
+
+	// Returns the counters since the last Clear, summed over every thread (including those which have exited)
+	EvaluationCacheStatistics Statistics() const;
+
+private:
+	static EvaluationCache instance;
+	EvaluationCache();
+
+	// Assumed size of a cache line, used to keep the counters of threads from false sharing with each other
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	// The counters of a thread, which only it writes. They are registered with the instance while the thread lives,
+	// and added to the counters of the exited threads when it exits
+	struct alignas(CACHE_LINE_SIZE) ThreadCounters {
+		std::atomic<uint64_t> hits{};
+		std::atomic<uint64_t> misses{};
+
+		ThreadCounters();
+		~ThreadCounters();
+	};
+
+	// Returns the counters of the calling thread
+	static ThreadCounters& Counters() {
+		thread_local ThreadCounters counters;
+		return counters;
+	}
+
+	// Counts one more by the thread owning the counter, which needs no read-modify-write
+	static void Count(std::atomic<uint64_t>& counter) {
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	static size_t Slot(const uint64_t key) {
+		return static_cast<size_t>(key & (SLOT_COUNT - 1));
+	}
+
+	static uint64_t Tag(const uint64_t key) {
+		return key >> VALUE_BITS;
+	}
+
+	// The bits of a slot holding the value, every goal function value fitting in them
+	static constexpr int VALUE_BITS = 16;
+	static_assert(Constants::INFINITE_SCORE <= INT16_MAX);
+
+	std::unique_ptr<std::atomic<uint64_t>[]> slots;
+
+	// The counters of the living threads, and the sums of the exited ones
+	mutable std::mutex mutex;
+	std::vector<ThreadCounters*> threads;
+	EvaluationCacheStatistics exited{};
+};
+
+inline std::optional<Score> EvaluationCache::Find(const uint64_t key) {
+	const auto entry = slots[Slot(key)].load(std::memory_order_relaxed);
+
+	// An empty slot is all zeros: a correct hit for the empty board, whose key and value are both 0,
+	// and for any other key no likelier a false hit than an occupied slot
+	if (entry >> VALUE_BITS == Tag(key)) {
+		Count(Counters().hits);
+		return static_cast<int16_t>(static_cast<uint16_t>(entry));
+	}
+	Count(Counters().misses);
+	return {};
+}
+
+inline void EvaluationCache::Store(const uint64_t key, const Score value) {
+	slots[Slot(key)].store(Tag(key) << VALUE_BITS | static_cast<uint16_t>(value), std::memory_order_relaxed);
+}
\ No newline at end of file
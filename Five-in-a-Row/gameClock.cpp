@@ -0,0 +1,50 @@
+#include "gameClock.hpp"
+
+#include <algorithm>
+
+template <size_t width, size_t height>
+TimeAllocation AllocateTime(const BasicBoard<width, height>& board, const bool blue, const GameClock& clock) {
+	using namespace Constants;
+	using Milliseconds = std::chrono::duration<double, std::milli>;
+
+	// A single forced ply takes no thought
+	const auto threats = board.ThreatPlies(blue);
+	if (threats.size() == 1) {
+		return { std::chrono::milliseconds(0), std::chrono::milliseconds(0) };
+	}
+
+	// The clock's share of every ply still expected, after a margin for everything but the search
+	const auto remaining = std::max(clock.remaining - std::chrono::milliseconds(CLOCK_MARGIN_MILLISECONDS),
+		std::chrono::milliseconds(0));
+	size_t pieces = 0, played = 0;
+	for (size_t pos = 0; pos < board.SIZE; ++pos) {
+		pieces += board.At(pos) != CellState::EMPTY;
+		played += board.At(pos) == (blue ? CellState::BLUE : CellState::RED);
+	}
+	const auto movesToGo = std::max(CLOCK_MIN_MOVES_TO_GO, CLOCK_MOVES_TO_GO - std::min(played, CLOCK_MOVES_TO_GO));
+	const auto share = Milliseconds(remaining) / movesToGo + Milliseconds(clock.increment) * 0.75;
+
+	// Scaled by the position
+	double factor;
+	if (pieces < CLOCK_OPENING_PIECES) {
+		factor = CLOCK_OPENING_FACTOR;
+	}
+	else if (!threats.empty()) {
+		factor = CLOCK_CRITICAL_FACTOR;
+	}
+	else {
+		factor = std::clamp(static_cast<double>(board.InRangePlies().size()) / CLOCK_TYPICAL_CANDIDATES, 0.5, 1.5);
+	}
+
+	// Never more than a part of what is left
+	const auto limit = std::min(Milliseconds(remaining), Milliseconds(remaining) / CLOCK_MAXIMUM_SHARE +
+		Milliseconds(clock.increment));
+	const auto maximum = std::min(share * factor * CLOCK_MAXIMUM_FACTOR, limit);
+	const auto target = std::min(share * factor, maximum);
+	return { std::chrono::duration_cast<std::chrono::milliseconds>(target),
+		std::chrono::duration_cast<std::chrono::milliseconds>(maximum) };
+}
+
+template TimeAllocation AllocateTime<15, 15>(const BasicBoard<15, 15>&, const bool, const GameClock&);
+template TimeAllocation AllocateTime<19, 19>(const BasicBoard<19, 19>&, const bool, const GameClock&);
+template TimeAllocation AllocateTime<7, 7>(const BasicBoard<7, 7>&, const bool, const GameClock&);
\ No newline at end of file
@@ -0,0 +1,27 @@
+// This header defines the game clock: the time a player has left for the rest of the game, and the time
+// added after each of its plies, and how the time of a ply is allocated from it.
+// The allocation is the clock's share per ply still expected, scaled by the position: less in the opening,
+// more when there are threats on the board, by the number of candidates otherwise, and none for a single
+// forced ply. The search itself stretches or shrinks it by the stability of its best ply (see BasicIterativeDeepening)
+
+#pragma once
+
+#include "board.hpp"
+
+#include <chrono>
+
+struct GameClock {
+	std::chrono::milliseconds remaining;
+	std::chrono::milliseconds increment{};
+};
+
+// The time a ply may take
+struct TimeAllocation {
+	// The search begins no deeper iteration after the target, and stops its root's children at the maximum
+	std::chrono::milliseconds target;
+	std::chrono::milliseconds maximum;
+};
+
+// Returns the time of the ply of the color to move on the board (of any instantiated size), on its clock
+template <size_t width, size_t height>
+TimeAllocation AllocateTime(const BasicBoard<width, height>& board, const bool blue, const GameClock& clock);
\ No newline at end of file
@@ -1,11 +1,33 @@
 // This header contains the definition of the goal function
 // Essentially, it just wraps the implementation function object
 // so that it can have static linkage and be a template argument for testing purposes
+// It is templated on the board dimensions, which are deduced when it is passed to Minimax
+// Both versions look the board up in the evaluation cache first, and only evaluate it on a miss
 #pragma once
 
 #include "board.hpp"
 #include "goalFunctionThreadPool.hpp"
+#include "evaluationCache.hpp"
 
-static float GoalFunction(const Board& board) {
-	return GoalFunctionThreadPool::Get()(&board);
+template <size_t width, size_t height>
+Score GoalFunction(const BasicBoard<width, height>& board) {
+	auto& cache = EvaluationCache::Get();
+	if (const auto value = cache.Find(board.Key())) {
+		return *value;
+	}
+	const Score value = GoalFunctionThreadPool::Get()(&board);
+	cache.Store(board.Key(), value);
+	return value;
+}
+
+// The goal function evaluated on the calling thread, which may be used by several searches at once
+template <size_t width, size_t height>
+Score InlineGoalFunction(const BasicBoard<width, height>& board) {
+	auto& cache = EvaluationCache::Get();
+	if (const auto value = cache.Find(board.Key())) {
+		return *value;
+	}
+	const Score value = GoalFunctionThreadPool::Get().Inline(&board);
+	cache.Store(board.Key(), value);
+	return value;
 }
\ No newline at end of file
@@ -2,12 +2,14 @@
 
 #include <numeric>
 #include <execution>
+#include <chrono>
+#include <algorithm>
+#include <variant>
+#include <utility>
+#include <type_traits>
 
 using namespace Constants;
 
-// This is the fastest policy on my machine
-constexpr auto policy = std::execution::unseq;
-
 GoalFunctionThreadPool GoalFunctionThreadPool::instance;
 
 GoalFunctionThreadPool& GoalFunctionThreadPool::Get() {
@@ -15,119 +17,258 @@ GoalFunctionThreadPool& GoalFunctionThreadPool::Get() {
 }
 
 // Counts the progress of all "fives" along an orientation, then transforms them according
-// to SCORE_MAP, before summing them
-template <FivesOrientation orientation> float GoalFunctionSubSet(const Board& board);
-
-template<>
-float GoalFunctionSubSet<FivesOrientation::HORIZONTAL>(const Board& board) {
+// to SCORE_MAP, before summing them. The sum is exact, so it doesn't depend on the policy
+template <FivesOrientation orientation, typename Policy, typename BoardType>
+Score GoalFunctionSubSet(const Policy& policy, const BoardType& board) {
+	constexpr const auto& roots = BoardType::template FivesRoots<orientation>();
 	return std::transform_reduce(policy,
-		HORIZONTAL_FIVES_ROOTS.begin(), HORIZONTAL_FIVES_ROOTS.end(),
-		0.0f, std::plus<float>(), [&](const size_t index) -> float {
-		auto score = board.CountFive<FivesOrientation::HORIZONTAL>(index);
+		roots.begin(), roots.end(),
+		Score{}, std::plus<Score>(), [&](const size_t index) -> Score {
+		auto score = board.template CountFive<orientation>(index);
 		if (score) {
 			if (score > 0) return Constants::SCORE_MAP[score - 1];
 			else return -Constants::SCORE_MAP[-score - 1];
 		}
-		else return 0.0f;
+		else return 0;
 	});
 }
 
-template<>
-float GoalFunctionSubSet<FivesOrientation::VERTICAL>(const Board& board) {
-	return std::transform_reduce(policy,
-		VERTICAL_FIVES_ROOTS.begin(), VERTICAL_FIVES_ROOTS.end(),
-		0.0f, std::plus<float>(), [&](const size_t index) -> float {
-		auto score = board.CountFive<FivesOrientation::VERTICAL>(index);
-		if (score) {
-			if (score > 0) return Constants::SCORE_MAP[score - 1];
-			else return -Constants::SCORE_MAP[-score - 1];
-		}
-		else return 0.0f;
-	});
+// Dispatches the runtime policy to the policy object
+template <FivesOrientation orientation, typename BoardType>
+Score GoalFunctionSubSet(const ReductionPolicy policy, const BoardType& board) {
+	switch (policy) {
+	case ReductionPolicy::SEQ:
+		return GoalFunctionSubSet<orientation>(std::execution::seq, board);
+	case ReductionPolicy::UNSEQ:
+		return GoalFunctionSubSet<orientation>(std::execution::unseq, board);
+	default:
+		return GoalFunctionSubSet<orientation>(std::execution::par_unseq, board);
+	}
 }
 
+// Dispatches the runtime orientation, with the board type erased so that the workers
+// can evaluate boards of any size
+template <typename BoardType>
+Score GoalFunctionSubSet(const void* board, const FivesOrientation orientation, const ReductionPolicy policy) {
+	const auto& typedBoard = *static_cast<const BoardType*>(board);
+	switch (orientation) {
+	case FivesOrientation::HORIZONTAL:
+		return GoalFunctionSubSet<FivesOrientation::HORIZONTAL>(policy, typedBoard);
+	case FivesOrientation::VERTICAL:
+		return GoalFunctionSubSet<FivesOrientation::VERTICAL>(policy, typedBoard);
+	case FivesOrientation::SOUTHEAST:
+		return GoalFunctionSubSet<FivesOrientation::SOUTHEAST>(policy, typedBoard);
+	default:
+		return GoalFunctionSubSet<FivesOrientation::SOUTHWEST>(policy, typedBoard);
+	}
+}
 
-template<>
-float GoalFunctionSubSet<FivesOrientation::SOUTHEAST>(const Board& board) {
-	return std::transform_reduce(policy,
-		SOUTHEAST_FIVES_ROOTS.begin(), SOUTHEAST_FIVES_ROOTS.end(),
-		0.0f, std::plus<float>(), [&](const size_t index) -> float {
-		auto score = board.CountFive<FivesOrientation::SOUTHEAST>(index);
-		if (score) {
-			if (score > 0) return Constants::SCORE_MAP[score - 1];
-			else return -Constants::SCORE_MAP[-score - 1];
-		}
-		else return 0.0f;
-	});
+// The orientations evaluated by the workers, in order
+constexpr FivesOrientation WORKER_ORIENTATIONS[] = {
+	FivesOrientation::HORIZONTAL, FivesOrientation::VERTICAL, FivesOrientation::SOUTHWEST
+};
+
+GoalFunctionThreadPool::GoalFunctionThreadPool() {
+	// Spinning only pays off if the caller and the workers actually run simultaneously
+	spinCount = std::thread::hardware_concurrency() > 1 ? SPIN_COUNT : 0;
+
+	// Pooled with unseq was the fastest on the original author's machine
+	for (auto& selection : selections) {
+		selection.store({ EvaluationMode::POOLED, ReductionPolicy::UNSEQ }, std::memory_order_relaxed);
+	}
+
+	// Run the threads
+	for (size_t i = 0; i < WORKER_COUNT; ++i) {
+		pool[i] = std::thread([this, i]() { Work(i); });
+	}
 }
 
+GoalFunctionThreadPool::~GoalFunctionThreadPool() {
+	Kill();
+}
 
-template<>
-float GoalFunctionSubSet<FivesOrientation::SOUTHWEST>(const Board& board) {
-	return std::transform_reduce(policy, 
-		SOUTHWEST_FIVES_ROOTS.begin(), SOUTHWEST_FIVES_ROOTS.end(),
-		0.0f, std::plus<float>(), [&](const size_t index) -> float {
-		auto score = board.CountFive<FivesOrientation::SOUTHWEST>(index);
-		if (score) {
-			if (score > 0) return Constants::SCORE_MAP[score - 1];
-			else return -Constants::SCORE_MAP[-score - 1];
-		}
-		else return 0.0f;
-	});
+void GoalFunctionThreadPool::Kill() {
+	if (instance.dead.exchange(true)) {
+		return;
+	}
+	// Wake the threads with a new generation, so that they see they're dead, and await them
+	instance.generation.fetch_add(1, std::memory_order_release);
+	instance.generation.notify_all();
+	for (auto& thread : instance.pool) {
+		thread.join();
+	}
 }
 
-GoalFunctionThreadPool::GoalFunctionThreadPool() {
+bool GoalFunctionThreadPool::Claim() {
+	// A killed pool can only evaluate inline
+	return !instance.dead.load(std::memory_order_acquire) && !instance.claimed.exchange(true, std::memory_order_acquire);
+}
 
-	// Run the threads
+void GoalFunctionThreadPool::Release() {
+	instance.claimed.store(false, std::memory_order_release);
+}
 
-	pool[0] = std::thread([&]() {
-		while (true) {
-			begin_signals[0].acquire();
-			if (dead) {
-				return;
-			}
-			results[0] = GoalFunctionSubSet<FivesOrientation::HORIZONTAL>(*board);
-			complete_signals[0].release();
-		}
-	});
-	pool[1] = std::thread([&]() {
-		while (true) {
-			begin_signals[1].acquire();
-			if (dead)
-				return;
-			results[1] = GoalFunctionSubSet<FivesOrientation::VERTICAL>(*board);
-			complete_signals[1].release();
-		}
-	});
-	pool[2] = std::thread([&]() {
-		while (true) {
-			begin_signals[2].acquire();
-			if (dead)
-				return;
-			results[2] = GoalFunctionSubSet<FivesOrientation::SOUTHWEST>(*board);
-			complete_signals[2].release();
+uint32_t GoalFunctionThreadPool::AwaitChange(const std::atomic<uint32_t>& value, const uint32_t old) const {
+	for (size_t i = 0; i < spinCount; ++i) {
+		if (const auto current = value.load(std::memory_order_acquire); current != old) {
+			return current;
 		}
-	});
+	}
+	value.wait(old, std::memory_order_acquire);
+	return value.load(std::memory_order_acquire);
 }
 
-void GoalFunctionThreadPool::Kill() {
-	instance.dead = true;
-	// Await the threads
-	for (size_t i = 0; i < 3; ++i) {
-		instance.begin_signals[i].release();
-		instance.pool[i].join();
+void GoalFunctionThreadPool::Work(const size_t i) {
+	uint32_t seen{};
+	while (true) {
+		seen = AwaitChange(generation, seen);
+		if (dead.load(std::memory_order_acquire)) {
+			return;
+		}
+		slots[i].result = subSet(board, WORKER_ORIENTATIONS[i], workPolicy);
+		slots[i].completed.store(seen, std::memory_order_release);
+		slots[i].completed.notify_one();
 	}
 }
 
-float GoalFunctionThreadPool::operator()(const Board* board) {
-	this->board = board;
-	for (size_t i = 0; i < 3; ++i) {
-		begin_signals[i].release();
+Score GoalFunctionThreadPool::Evaluate(const void* board, const SubSetFunction subSet,
+	const EvaluationMode mode, const ReductionPolicy policy) {
+	if (mode == EvaluationMode::INLINE) {
+		// Same summation order as the pooled evaluation
+		return subSet(board, FivesOrientation::SOUTHEAST, policy) +
+			subSet(board, FivesOrientation::HORIZONTAL, policy) +
+			subSet(board, FivesOrientation::VERTICAL, policy) +
+			subSet(board, FivesOrientation::SOUTHWEST, policy);
 	}
+
+	this->board = board;
+	this->subSet = subSet;
+	workPolicy = policy;
+	// Publishing the new generation releases the board, the function and the policy to the workers
+	const auto current = generation.fetch_add(1, std::memory_order_release) + 1;
+	generation.notify_all();
+
 	// The fourth orientation is run on this thread
-	float mainResult = GoalFunctionSubSet<FivesOrientation::SOUTHEAST>(*board);
-	for (size_t i = 0; i < 3; ++i) {
-		complete_signals[i].acquire();
+	Score result = subSet(board, FivesOrientation::SOUTHEAST, policy);
+
+	// Join the workers. A worker's completed generation is always either current - 1 or current
+	for (auto& slot : slots) {
+		AwaitChange(slot.completed, current - 1);
+		result += slot.result;
 	}
-	return mainResult + results[0] + results[1] + results[2];
-}
\ No newline at end of file
+	return result;
+}
+
+// A won board is scored outright, and any other board strictly within MAX_HEURISTIC_SCORE
+Score BoundScore(const Score score) {
+	return std::clamp(score, -MAX_HEURISTIC_SCORE + 1, MAX_HEURISTIC_SCORE - 1);
+}
+
+// The index of the board's size in AnyBoard, and in the calibrations
+template <typename BoardType, size_t index = 0>
+constexpr size_t SizeIndex() {
+	if constexpr (std::is_same_v<std::variant_alternative_t<index, AnyBoard>, BoardType>) {
+		return index;
+	}
+	else {
+		return SizeIndex<BoardType, index + 1>();
+	}
+}
+
+template <size_t width, size_t height>
+Score GoalFunctionThreadPool::operator()(const BasicBoard<width, height>* board) {
+	if (board->RedWin()) return WIN_SCORE;
+	if (board->BlueWin()) return -WIN_SCORE;
+	auto [mode, policy] = selections[SizeIndex<BasicBoard<width, height>>()].load(std::memory_order_relaxed);
+	// A killed pool has no workers left to wait for
+	if (dead.load(std::memory_order_acquire)) {
+		mode = EvaluationMode::INLINE;
+	}
+	return BoundScore(Evaluate(board, GoalFunctionSubSet<BasicBoard<width, height>>, mode, policy));
+}
+
+template <size_t width, size_t height>
+Score GoalFunctionThreadPool::Inline(const BasicBoard<width, height>* board) {
+	if (board->RedWin()) return WIN_SCORE;
+	if (board->BlueWin()) return -WIN_SCORE;
+	const auto policy = selections[SizeIndex<BasicBoard<width, height>>()].load(std::memory_order_relaxed).policy;
+	return BoundScore(Evaluate(board, GoalFunctionSubSet<BasicBoard<width, height>>, EvaluationMode::INLINE, policy));
+}
+
+const EvaluationCalibrations& GoalFunctionThreadPool::Calibrate() {
+	std::call_once(instance.calibrated, []() {
+		const bool pooled = Claim();
+		[&]<size_t... indices>(std::index_sequence<indices...>) {
+			(instance.Measure<std::variant_alternative_t<indices, AnyBoard>>(instance.calibrations[indices], pooled), ...);
+		}(std::make_index_sequence<std::variant_size_v<AnyBoard>>());
+		if (pooled) {
+			Release();
+		}
+	});
+	return instance.calibrations;
+}
+
+template <typename BoardType>
+void GoalFunctionThreadPool::Measure(EvaluationCalibration& calibration, const bool pooled) {
+	constexpr size_t BOARD_COUNT = 3;
+	constexpr size_t PIECE_COUNTS[BOARD_COUNT] = { 8, 40, 100 };
+	constexpr size_t WARMUP_ITERATIONS = 16;
+	constexpr size_t ITERATIONS = 256;
+
+	// Scatter pieces pseudo-randomly (but reproducibly), skipping plies that would win the game
+	BoardType boards[BOARD_COUNT];
+	uint32_t state = 0x2545F491;
+	for (size_t b = 0; b < BOARD_COUNT; ++b) {
+		for (size_t piece = 0; piece < PIECE_COUNTS[b] && piece < BoardType::SIZE / 2; ++piece) {
+			state = state * 1664525 + 1013904223;
+			const auto pos = (state >> 8) % BoardType::SIZE;
+			if (boards[b].At(pos) != CellState::EMPTY) continue;
+			const auto next = boards[b].Play(pos, piece % 2);
+			if (!next.BlueWin() && !next.RedWin()) boards[b] = next;
+		}
+	}
+
+	auto& selection = selections[SizeIndex<BoardType>()];
+	const auto initial = selection.load(std::memory_order_relaxed);
+	calibration = { BoardType::WIDTH, BoardType::HEIGHT, initial.mode, initial.policy, {} };
+	double fastest = std::numeric_limits<double>::infinity();
+	for (const auto mode : { EvaluationMode::INLINE, EvaluationMode::POOLED }) {
+		// A pool claimed by someone else can only be timed inline
+		if (mode == EvaluationMode::POOLED && !pooled) continue;
+		for (const auto policy : { ReductionPolicy::SEQ, ReductionPolicy::UNSEQ, ReductionPolicy::PAR_UNSEQ }) {
+			// Only written, so that the evaluations aren't optimized away
+			[[maybe_unused]] volatile Score sink{};
+			for (size_t i = 0; i < WARMUP_ITERATIONS; ++i) {
+				sink = Evaluate(&boards[i % BOARD_COUNT], GoalFunctionSubSet<BoardType>, mode, policy);
+			}
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < ITERATIONS; ++i) {
+				for (const auto& board : boards) {
+					sink = Evaluate(&board, GoalFunctionSubSet<BoardType>, mode, policy);
+				}
+			}
+			const auto nanoseconds = std::chrono::duration<double, std::nano>(
+				std::chrono::steady_clock::now() - start).count() / (ITERATIONS * BOARD_COUNT);
+
+			calibration.nanoseconds[static_cast<size_t>(mode)][static_cast<size_t>(policy)] = nanoseconds;
+			if (nanoseconds < fastest) {
+				fastest = nanoseconds;
+				calibration.mode = mode;
+				calibration.policy = policy;
+			}
+		}
+	}
+
+	// Publish the selection once it is complete
+	selection.store({ calibration.mode, calibration.policy }, std::memory_order_relaxed);
+}
+
+// Explicit instantiations, which must match AnyBoard
+
+template Score GoalFunctionThreadPool::operator()(const BasicBoard<15, 15>* board);
+template Score GoalFunctionThreadPool::operator()(const BasicBoard<19, 19>* board);
+template Score GoalFunctionThreadPool::operator()(const BasicBoard<7, 7>* board);
+
+template Score GoalFunctionThreadPool::Inline(const BasicBoard<15, 15>* board);
+template Score GoalFunctionThreadPool::Inline(const BasicBoard<19, 19>* board);
+template Score GoalFunctionThreadPool::Inline(const BasicBoard<7, 7>* board);
\ No newline at end of file
@@ -1,46 +1,142 @@
 // This header defines the goal function thread pool function object, which implements the goal function
 // and manages a thread pool. It is a singleton, so that it can be used statically.
 
-// Global resource management causes spaghetti code. The singleton cannot kill it's own threads,
-// because it's destructor won't be called until it's threads stop running. I wanted the static
-// linkage for testing and threaded implementation for speed, which came at this cost.
-// The DecisionComputer class kills the threadpool in it's destructor.
+// Each call is a fork-join: the caller bumps a generation counter, which the workers wait on
+// (spinning briefly before blocking through std::atomic::wait), and then spins/waits on each
+// worker's completed generation. This avoids the kernel round trips of a semaphore pair per worker,
+// which used to dominate the tiny amount of work per call.
+
+// Whether the fork-join (or the execution policy within each orientation) pays off depends on the
+// machine, so Calibrate times every combination on synthetic boards and selects the fastest, once per process.
+// The selections are published atomically, so the searches may read them while a calibration runs.
+
+// operator() is not reentrant, so only one user at a time may evaluate through the pool: whoever has claimed it
+// (see Claim). Everyone else evaluates inline, through Inline, which is.
+
+// The pool joins its threads in its destructor. Kill may be called to do so earlier, e.g. when
+// the pool lives in a DLL (the unit tests), where joining during static destruction is unsafe.
 
 #pragma once
 
 #include "constants.hpp"
 #include "board.hpp"
 
-#include <semaphore>
+#include <atomic>
 #include <thread>
+#include <mutex>
+#include <cstdint>
+#include <array>
+#include <variant>
+
+// Where the four orientations of the goal function are evaluated
+enum class EvaluationMode { INLINE, POOLED };
+
+// The execution policy used to reduce the "fives" of one orientation
+enum class ReductionPolicy { SEQ, UNSEQ, PAR_UNSEQ };
+
+// The outcome of GoalFunctionThreadPool::Calibrate for one board size
+struct EvaluationCalibration {
+	size_t width;
+	size_t height;
+	EvaluationMode mode;
+	ReductionPolicy policy;
+	// Average nanoseconds per goal function call, indexed by [mode][policy]
+	double nanoseconds[2][3];
+};
+
+// The calibrations of every board size, in the order of AnyBoard
+using EvaluationCalibrations = std::array<EvaluationCalibration, std::variant_size_v<AnyBoard>>;
 
 class GoalFunctionThreadPool {
 public:
 	// Returns a reference to the instance
 	static GoalFunctionThreadPool& Get();
 
-	// Kills the thread pool
+	// Kills the thread pool, which then evaluates inline. Safe to call more than once
 	static void Kill();
 
-	// Returns the value of the goal function for the board
-	float operator()(const Board* board);
+	// Claims the pool for the caller, whose evaluations alone may then go through operator(), until it releases it.
+	// Returns false if the pool is claimed already, or killed
+	static bool Claim();
+
+	// Releases the caller's claim
+	static void Release();
+
+	// Times every mode and policy on synthetic boards of every size, and selects the fastest for each size (the work
+	// per call, and so what pays off, grows with the board). It only runs once: later calls,
+	// from any thread, wait for the first one and return its result.
+	// It claims the pool to time the pooled mode, which it leaves out if the pool is claimed already
+	static const EvaluationCalibrations& Calibrate();
+
+	// Returns the value of the goal function for the board (of any instantiated size), for the claimant of the pool:
+	// WIN_SCORE or -WIN_SCORE if it is won, else the sum of the "fives" scores, strictly within MAX_HEURISTIC_SCORE
+	template <size_t width, size_t height>
+	Score operator()(const BasicBoard<width, height>* board);
+
+	// Returns the value of the goal function for the board, evaluated on the calling thread only.
+	// Unlike operator(), it may be called from several threads at once (e.g. by the opening book builder)
+	template <size_t width, size_t height>
+	Score Inline(const BasicBoard<width, height>* board);
+
+	~GoalFunctionThreadPool();
 
 private:
 	static GoalFunctionThreadPool instance;
 	GoalFunctionThreadPool();
 
-	std::thread pool[3];
-	std::binary_semaphore begin_signals[3] = {
-		std::binary_semaphore{0},
-		std::binary_semaphore{0},
-		std::binary_semaphore{0}
+	// The number of threads in the pool; the fourth orientation is evaluated by the caller
+	static constexpr size_t WORKER_COUNT = 3;
+
+	// How many times a thread polls an atomic before blocking on it
+	static constexpr size_t SPIN_COUNT = 4096;
+
+	// Assumed size of a cache line, used to keep the workers from false sharing
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	// The result of one worker and the generation it was computed for, on its own cache line
+	struct alignas(CACHE_LINE_SIZE) Slot {
+		Score result;
+		std::atomic<uint32_t> completed{};
 	};
-	std::binary_semaphore complete_signals[3] = {
-		std::binary_semaphore{0},
-		std::binary_semaphore{0},
-		std::binary_semaphore{0}
+
+	// Evaluates one orientation of a type-erased board
+	using SubSetFunction = Score(*)(const void* board, const FivesOrientation orientation,
+		const ReductionPolicy policy);
+
+	// Evaluates the board with the given mode and policy
+	Score Evaluate(const void* board, const SubSetFunction subSet,
+		const EvaluationMode mode, const ReductionPolicy policy);
+
+	// Times every mode (the pooled one only if pooled) and policy on boards of the type into calibration,
+	// and publishes the fastest to its selection
+	template <typename BoardType>
+	void Measure(EvaluationCalibration& calibration, const bool pooled);
+
+	// Blocks until value differs from old (spinning spinCount times first), then returns it
+	uint32_t AwaitChange(const std::atomic<uint32_t>& value, const uint32_t old) const;
+
+	// The loop run by worker i
+	void Work(const size_t i);
+
+	std::thread pool[WORKER_COUNT];
+	alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> generation{};
+	std::atomic<bool> dead{};
+	std::atomic<bool> claimed{};
+	const void* board{};
+	SubSetFunction subSet{};
+	ReductionPolicy workPolicy{};
+	size_t spinCount{};
+	Slot slots[WORKER_COUNT];
+
+	// The mode and policy in use for each board size, as one atomic so that they are always read together
+	struct Selection {
+		EvaluationMode mode;
+		ReductionPolicy policy;
 	};
-	const Board* board;
-	float results[3];
-	bool dead{};
+	// Every size starts with the default selection (see the constructor), until calibrated
+	std::array<std::atomic<Selection>, std::variant_size_v<AnyBoard>> selections;
+
+	// The outcome of the calibration, written once before the selections are published
+	EvaluationCalibrations calibrations{};
+	std::once_flag calibrated;
 };
\ No newline at end of file
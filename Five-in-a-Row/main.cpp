@@ -13,21 +13,135 @@
 
 // If you get bored, or it's too hard to beat me or I'm too slow, go mess with the settings in "constants.hpp"
 
+// Run with --build-book to build the opening book (which takes a while) instead of playing
+// Run with --render-check to draw a few frames in a hidden window and print what they took, e.g. headless
+// under Mesa's software rasterizer (LIBGL_ALWAYS_SOFTWARE=1, in a virtual display)
+
 #include "scopedLibrary.hpp"
 #include "window.hpp"
 #include "renderer.hpp"
 #include "decisionComputer.hpp"
+#include "searchProgress.hpp"
+#include "gameClock.hpp"
+#include "goalFunction.hpp"
+#include "openingBook.hpp"
 
 #include <fstream>
 #include <stack>
+#include <iostream>
+#include <chrono>
+#include <format>
+#include <string_view>
+#include <future>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <limits>
+
+// Calibrates the goal function (see GoalFunctionThreadPool::Calibrate), and logs the selection and the timings
+// of every board size
+void LogCalibration() {
+	constexpr const char* MODES[] = { "inline", "pooled" };
+	constexpr const char* POLICIES[] = { "seq", "unseq", "par_unseq" };
+	for (const auto& size : GoalFunctionThreadPool::Calibrate()) {
+		const auto& ns = size.nanoseconds;
+		std::clog << std::format("Goal function on {}x{}: {} {} (ns/call seq/unseq/par_unseq: "
+			"inline {:.0f}/{:.0f}/{:.0f}, pooled {:.0f}/{:.0f}/{:.0f})\n", size.width, size.height,
+			MODES[static_cast<size_t>(size.mode)], POLICIES[static_cast<size_t>(size.policy)],
+			ns[0][0], ns[0][1], ns[0][2], ns[1][0], ns[1][1], ns[1][2]);
+	}
+}
+
+// Searches the opening tree on every core and writes the book
+void BuildBook() {
+	LogCalibration();
+	const auto start = std::chrono::steady_clock::now();
+	const auto entries = OpeningBook::Search<Constants::BOOK_PLY_LOOK_AHEAD, InlineGoalFunction>(
+		Constants::BOOK_PIECES, std::thread::hardware_concurrency());
+	OpeningBook::Write(Constants::OPENING_BOOK_PATH, entries);
+	std::cout << std::format("Wrote {} positions to {} in {:.1f} s\n", entries.size(), Constants::OPENING_BOOK_PATH,
+		std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+// Draws the frames of a short game, and prints their draw calls, instance buffer writes and times.
+// Fails unless every frame is a single draw call
+int RenderCheck() {
+	ScopedLibrary lib;
+	Window window(false);
+	Renderer renderer;
+
+	Board board;
+	std::optional<size_t> lastPly;
+	bool blue = false, single = true;
+	const auto frame = [&](const char* what) {
+		const auto start = std::chrono::steady_clock::now();
+		const auto drawn = renderer.Draw(window, board, false, lastPly);
+		std::cout << std::format("{:<12} {} draw calls, {:>3} instances written, {:.2f} ms\n", what, drawn.drawCalls,
+			drawn.updatedInstances, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		single = single && drawn.drawCalls == 1;
+	};
+
+	frame("First");
+	frame("Unchanged");
+	for (const auto& [x, y] : { std::pair<size_t, size_t>{ 7, 7 }, { 8, 8 }, { 6, 7 }, { 8, 7 } }) {
+		lastPly = y * Constants::BOARD_WIDTH + x;
+		board = board.Play(*lastPly, blue);
+		blue = !blue;
+		frame("Ply");
+	}
+	return single ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-auto main() -> int {
+auto main(int argc, char* argv[]) -> int {
 	try {
-		DecisionComputer computer;
+		if (argc > 1 && std::string_view(argv[1]) == "--build-book") {
+			BuildBook();
+			return EXIT_SUCCESS;
+		}
+		if (argc > 1 && std::string_view(argv[1]) == "--render-check") {
+			return RenderCheck();
+		}
+
+		LogCalibration();
+
+		// The computer's answer, while it is awaited, how far its search has got, and the updates shown of it
+		std::future<Decision> decision;
+		auto progress = std::make_shared<SearchProgress>();
+		uint64_t shownUpdates = 0;
+
+		// The computer's game clock, if it plays on one
+		const auto newClock = []() -> std::optional<GameClock> {
+			if (!Constants::CLOCK_MILLISECONDS) {
+				return std::nullopt;
+			}
+			return GameClock{ std::chrono::milliseconds(Constants::CLOCK_MILLISECONDS),
+				std::chrono::milliseconds(Constants::CLOCK_INCREMENT_MILLISECONDS) };
+		};
+		auto clock = newClock();
 
 		ScopedLibrary lib;
 		Window window;
+		const auto started = std::chrono::steady_clock::now();
 		Renderer renderer;
+		std::clog << std::format("Renderer ready in {:.1f} ms (shader program {})\n",
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count(),
+			renderer.ShaderCached() ? "cached" : "compiled");
+
+		// The computer wakes the main loop when it has answered. Declared after the library and window,
+		// so it is destroyed (and stops waking them) first
+		DecisionComputer computer(Constants::ENGINE, Constants::DECISION_WORKERS, Window::Wake);
+
+		// What the last frame showed. The loop sleeps until there is input or an answer, and only draws
+		// a frame when what it shows has changed (or the window has lost it)
+		struct Frame {
+			uint64_t key;
+			std::optional<size_t> lastPly;
+			std::optional<size_t> selected;
+			bool operator==(const Frame&) const = default;
+		};
+		std::optional<Frame> shown;
+		// The times the loop woke up and drew while the computer was thinking
+		uint64_t wakeups = 0, frames = 0;
 
 		Board board;
 		std::stack<size_t> plies;
@@ -38,20 +152,76 @@ auto main() -> int {
 
 		// Main loop
 		while (!window.ShouldClose()) {
+			wakeups += decision.valid();
+
 			// Game logic
 			if (!gameOver) {
 
 				// Are we awaiting a decision from the computer?
-				if (computer.Running()) {
+				if (decision.valid()) {
 
 					// Has it reached the decision?
-					if (auto ply = computer.TryResult()) {
-						plies.push(*ply);
-						board = board.Play(*ply, playerTurn);
+					if (decision.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+						const auto answer = decision.get();
+						const auto ply = answer.ply;
+						const auto& report = answer.report;
+						if (report.tactic != Tactic::NONE) {
+							const auto tactics = computer.Tactics();
+							std::clog << std::format("Ply {} in {:.3f} ms ({}; {} of {} checks forced, {:.3f} ms on them)\n", ply,
+								report.milliseconds, report.tactic == Tactic::WIN ? "win" : report.tactic == Tactic::BLOCK ?
+								"block" : "double threat", tactics.wins + tactics.blocks + tactics.doubleThreats, tactics.checks,
+								tactics.milliseconds);
+						}
+						else if (report.playouts) {
+							std::clog << std::format("Ply {} in {:.1f} ms ({}; {} playouts)\n", ply,
+								report.milliseconds, report.reused ? "recycled" : "fresh", report.playouts);
+						}
+						else {
+							std::clog << std::format("Ply {} in {:.1f} ms ({}; {} of {} probes hit, {} cutoffs)\n", ply,
+								report.milliseconds, report.book ? "book" : report.reused ? "reused" : "fresh",
+								report.statistics.hits, report.statistics.probes, report.statistics.cutoffs);
+						}
+						if (report.variation.size() > 1) {
+							std::clog << "  Expecting";
+							for (auto reply = report.variation.begin() + 1; reply != report.variation.end(); ++reply) {
+								std::clog << ' ' << *reply;
+							}
+							std::clog << '\n';
+						}
+						// The computer's own decisions run its clock: the time they took comes off it, and the increment is added
+						if (clock && !playerTurn) {
+							const auto spent = std::chrono::duration_cast<std::chrono::milliseconds>(
+								std::chrono::duration<double, std::milli>(report.queuedMilliseconds + report.milliseconds));
+							clock->remaining = std::max(clock->remaining - spent, std::chrono::milliseconds(0)) + clock->increment;
+							std::clog << std::format("  Allocated {:.1f} ms, took {} ms at depth {}; {} ms left\n",
+								report.allocatedMilliseconds, spent.count(), report.depth, clock->remaining.count());
+						}
+						std::clog << std::format("  Woke {} times and drew {} frames meanwhile\n", wakeups, frames);
+						wakeups = frames = 0;
+						for (const auto& line : answer.analysis) {
+							std::clog << std::format("  {:+6}", line.score);
+							for (const auto reply : line.variation) {
+								std::clog << ' ' << reply;
+							}
+							std::clog << '\n';
+						}
+						plies.push(ply);
+						board = board.Play(ply, playerTurn);
 						playerTurn = !playerTurn;
 						window.SetTitle((std::string(Constants::APPLICATION_NAME) + (playerTurn ?
 							Constants::PLAYER_TURN_SUFFIX : Constants::COMPUTER_TURN_SUFFIX)).c_str());
 					}
+
+					// Else show its best ply so far, if it has found a better one since
+					else if (const auto current = progress->Read(); current.updates != shownUpdates) {
+						shownUpdates = current.updates;
+						const auto detail = current.total ?
+							std::format(" {}/{} at depth {}, best {} ({:+})", current.searched, current.total, current.depth,
+								current.ply, current.score) :
+							std::format(" {} playouts, best {}", current.searched, current.ply);
+						window.SetTitle((std::string(Constants::APPLICATION_NAME) + Constants::COMPUTER_TURN_SUFFIX +
+							detail).c_str());
+					}
 				}
 				else {
 					if (playerTurn) {
@@ -68,14 +238,18 @@ auto main() -> int {
 						// Has the player asked for help?
 						else if (window.HelpPressed()) {
 							window.SetTitle((std::string(Constants::APPLICATION_NAME) + Constants::COMPUTER_TURN_SUFFIX).c_str());
-							computer(board, true);
+							progress = std::make_shared<SearchProgress>();
+							shownUpdates = 0;
+							decision = computer.Submit(board, true, 0, Constants::HINT_LINES, progress);
 						}
 
 						
 					}
 					else {
 						// It's the computer's turn, notify it to begin computation
-						computer(board, false);
+						progress = std::make_shared<SearchProgress>();
+						shownUpdates = 0;
+						decision = computer.Submit(board, false, 0, 0, progress, clock);
 					}
 				}
 
@@ -88,44 +262,53 @@ auto main() -> int {
 					gameOver = true;
 					window.SetTitle((std::string(Constants::APPLICATION_NAME) + Constants::COMPUTER_WIN_SUFFIX).c_str());
 				}
-				else if (board.Full()) {
+				else if (board.Drawn()) {
 					gameOver = true;
 					window.SetTitle((std::string(Constants::APPLICATION_NAME) + Constants::DRAW_SUFFIX).c_str());
 				}
 			}
 
 			// Has the player requested to reset the board?
-			if (window.ResetPressed() && !computer.Running()) {
-				// No threads left behind
-				if (computer.Running()) {
-					computer.Await();
-				}
+			if (window.ResetPressed() && !decision.valid()) {
 				board = Board{};
+				computer.Invalidate();
 				gameOver = false;
 				playerFirst = !playerFirst;
 				playerTurn = playerFirst;
 				plies = {};
+				clock = newClock();
 				window.SetTitle((std::string(Constants::APPLICATION_NAME) + (playerTurn ?
 					Constants::PLAYER_TURN_SUFFIX : Constants::COMPUTER_TURN_SUFFIX)).c_str());
 			}
 
 			// Has the player requested to undo the top move?
-			if (plies.size() > 1 && window.UndoPressed() && !computer.Running()) {
+			if (plies.size() > 1 && window.UndoPressed() && !decision.valid()) {
 				board = board.Reset(plies.top());
 				plies.pop();
 				board = board.Reset(plies.top());
 				plies.pop();
+				computer.Invalidate();
 				gameOver = false;
 				window.SetTitle((std::string(Constants::APPLICATION_NAME) + (playerTurn ?
 					Constants::PLAYER_TURN_SUFFIX : Constants::COMPUTER_TURN_SUFFIX)).c_str());
 			}
 
-			// Poll window and update input state
-			window.Update();
+			// Draw board, if anything has changed
+			const bool drawSelected = playerTurn && !gameOver;
+			const Frame frame{ board.Key(), !plies.empty() ? std::make_optional(plies.top()) : std::nullopt,
+				drawSelected ? board.Selected(window.CursorPosition()) : std::nullopt };
+			if (frame != shown || window.Damaged()) {
+				renderer.Draw(window, board, drawSelected, frame.lastPly);
+				shown = frame;
+				frames += decision.valid();
+			}
 
-			// Draw board
-			renderer.Draw(window, board, playerTurn && !gameOver, !plies.empty() ?
-				std::make_optional(plies.top()) : std::nullopt);
+			// Sleep until there is input, or an answer. While thinking, wake now and then to show the progress.
+			// The computer is asked for its ply on the pass after it got the turn (by the player's ply, or a reset),
+			// so this one mustn't wait at all: the input which handed it the turn has been taken already
+			const bool asking = !playerTurn && !gameOver && !decision.valid();
+			window.Update(asking ? 0.0 : decision.valid() ? Constants::PROGRESS_SECONDS :
+				std::numeric_limits<double>::infinity());
 		}
 	}
 	catch (const std::exception& err) {
@@ -0,0 +1,88 @@
+#include "mappedFile.hpp"
+
+#include <stdexcept>
+#include <format>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+	// There is nothing to map (and nothing that can be mapped) in a missing or empty file
+	if (!std::filesystem::exists(path)) return;
+	const auto fileSize = std::filesystem::file_size(path);
+	if (fileSize == 0) return;
+
+#ifdef _WIN32
+	// The view keeps the mapping (and the file) open, so both handles can be closed right away
+	const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error(std::format("Could not open {}: error {}", path.string(), GetLastError()));
+	}
+	const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping) {
+		throw std::runtime_error(std::format("Could not map {}: error {}", path.string(), GetLastError()));
+	}
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view) {
+		throw std::runtime_error(std::format("Could not map {}: error {}", path.string(), GetLastError()));
+	}
+#else
+	// The mapping keeps the file open, so the descriptor can be closed right away
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file == -1) {
+		throw std::runtime_error(std::format("Could not open {}", path.string()));
+	}
+	const void* view = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (view == MAP_FAILED) {
+		throw std::runtime_error(std::format("Could not map {}", path.string()));
+	}
+#endif
+
+	data = static_cast<const std::byte*>(view);
+	size = static_cast<size_t>(fileSize);
+}
+
+MappedFile::~MappedFile() noexcept {
+	Unmap();
+}
+
+// Transfer ownership (if other is mapping)
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+	data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+
+// Transfer ownership (if other is mapping), unmapping the current file
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		Unmap();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+	}
+	return *this;
+}
+
+std::span<const std::byte> MappedFile::Bytes() const noexcept {
+	return { data, size };
+}
+
+void MappedFile::Unmap() noexcept {
+	if (!data) return;
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap(const_cast<std::byte*>(data), size);
+#endif
+	data = nullptr;
+	size = 0;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// RAII wrapper of a read-only memory mapping of a whole file
+// Like ScopedLibrary, responsibility can be moved and not copied
+// The pages are loaded lazily by the operating system and shared between processes mapping the same file,
+// so "opening" a large file costs next to nothing
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <cstddef>
+
+class MappedFile {
+public:
+	// Maps nothing
+	MappedFile() noexcept = default;
+
+	// Maps the file at path. A missing or empty file maps nothing, any other failure throws
+	explicit MappedFile(const std::filesystem::path& path);
+
+	~MappedFile() noexcept;
+
+	// The program can move the responsibility of unmapping
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	// MappedFile cannot be copied
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Returns the mapped bytes, which are empty if nothing is mapped
+	std::span<const std::byte> Bytes() const noexcept;
+
+private:
+	// Unmaps the file, if mapped
+	void Unmap() noexcept;
+
+	const std::byte* data{};
+	size_t size{};
+};
\ No newline at end of file
@@ -1,89 +1,282 @@
-// The minimax implementation is templated, both for unit testing but also for 
+// The minimax implementation is templated, both for unit testing but also for
 // compile-time unrolling of the recursion. For partial template specialization,
 // it must be a function object.
 
+// The goal function's wins, WIN_SCORE, become scores which count the plies left to the horizon,
+// WIN_SCORE + depth, so that a faster win or a slower loss is better (see Constants::WIN_SCORE).
+// The transposition table keeps them relative to the position instead, as wins in some number of plies
+
+// Every search may be given a SearchContext, which it reads and updates as it goes:
+// transposition table entries cut off or order the search of a position, and the history of plies
+// which caused cutoffs orders the children of depths which aren't sorted. The search also leaves its principal
+// variation in the context (see SearchContext::Variation). Without one, the search is unchanged
+
+// Quiet plies (see Board::Tactical) may be searched one ply shallower when ordered late (late move reductions),
+// or skipped one ply above the horizon when the node's own value is too far outside the window (futility pruning).
+// Both are configured in Constants, and neither applies to the root's children
+
+// The searches of the root's children may be given a SearchProgress, to which they publish the best ply so far
+// after every child (and the first ply, scored by the goal function, before them), and a deadline, after which
+// they search no more children. A deadline set on the context (see SearchContext::SetDeadline) also stops the search
+// within a child: every node unwinds without storing anything, and the root ignores the unfinished child
+
+// With Constants::THREAT_CANDIDATES, a node with threats on the board only searches the plies they force
+// (see Board::ThreatPlies), e.g. just the block of a four, instead of every in-range ply
+
 #pragma once
 
 #include <utility>
-#include <limits>
 #include <algorithm>
+#include <vector>
+#include <chrono>
 
 #include "board.hpp"
+#include "searchContext.hpp"
+#include "searchProgress.hpp"
+#include "gameClock.hpp"
+
+// Returns the score of the goal function's value at a node with depth plies left to the horizon
+inline Score SearchScore(const Score value, const size_t depth) {
+	if (value >= Constants::WIN_SCORE) return Constants::WIN_SCORE + static_cast<Score>(depth);
+	if (value <= -Constants::WIN_SCORE) return -(Constants::WIN_SCORE + static_cast<Score>(depth));
+	return value;
+}
+
+// Is the score a won (or lost) one?
+inline bool IsWinScore(const Score score) {
+	return score >= Constants::MAX_HEURISTIC_SCORE || score <= -Constants::MAX_HEURISTIC_SCORE;
+}
+
+// Converts a win score at a node with depth plies left between relative to the horizon
+// (the search's) and relative to the position (the transposition table's)
+inline Score ToTableScore(const Score score, const size_t depth) {
+	if (!IsWinScore(score)) return score;
+	return score > 0 ? score - static_cast<Score>(depth) : score + static_cast<Score>(depth);
+}
+inline Score FromTableScore(const Score score, const size_t depth) {
+	if (!IsWinScore(score)) return score;
+	return score > 0 ? score + static_cast<Score>(depth) : score - static_cast<Score>(depth);
+}
+
+// Returns the plies to search from the board, for the color to move
+template<typename BoardType>
+std::vector<size_t> CandidatePlies(const BoardType& board, const bool blue) {
+	if constexpr (Constants::THREAT_CANDIDATES) {
+		return board.CandidatePlies(blue);
+	}
+	else {
+		return board.InRangePlies();
+	}
+}
+
+// A root ply with the score of its search and its principal variation: the ply and the best replies after it.
+// The variation ends early where the game does, or where the transposition table cut the search off
+struct ScoredPly {
+	size_t ply;
+	Score score;
+	std::vector<size_t> variation;
+};
+
+// Stores the plies of the line, which was expected to follow the board, as the best plies of its positions,
+// so that the next search tries them first even if their entries were replaced. The entries are of depth 0,
+// so they never cut off a search, and they don't replace a deeper entry of any position (see SearchContext::Store)
+template<typename BoardType>
+void FollowVariation(BoardType board, bool max, const std::vector<size_t>& line, SearchContext& context) {
+	for (const auto ply : line) {
+		if (ply >= BoardType::SIZE || board.At(ply) != CellState::EMPTY) {
+			return;
+		}
+		context.Store(board.Key(), max, 0, 0, ply, Bound::EXACT);
+		board = board.Play(ply, !max);
+		max = !max;
+	}
+}
 
 // Primary struct declaration
 
-// Minimax search with function F
+// Minimax search with function F, on boards of type BoardType
 // if returnChild is true, the best immediate child (position) is returned
 // else, the algorithm is agnostic to which of its children is best, simply returning its value
-template<size_t depth, bool max, float(*F)(const Board&), bool returnChild = false> struct Minimax;
+// rootDepth is the depth of the search's root, which the depths sorted are counted from (see Constants::SORTING_DEPTH)
+template<typename BoardType, size_t depth, bool max, Score(*F)(const BoardType&), bool returnChild = false,
+	size_t rootDepth = depth>
+struct BasicMinimax;
+
+// Minimax search on the configured board
+template<size_t depth, bool max, Score(*F)(const Board&), bool returnChild = false>
+using Minimax = BasicMinimax<Board, depth, max, F, returnChild>;
 
 
 // General depth, partial specialization returning the tree's value (child agnostic)
-template<size_t depth, bool max, float(*F)(const Board&)>
-struct Minimax<depth, max, F, false> {
-	float operator()(const Board& board,
-		float alpha = -std::numeric_limits<float>::infinity(),
-		float beta = std::numeric_limits<float>::infinity()) const {
+template<typename BoardType, size_t depth, bool max, Score(*F)(const BoardType&), size_t rootDepth>
+struct BasicMinimax<BoardType, depth, max, F, false, rootDepth> {
+	Score operator()(const BoardType& board,
+		Score alpha = -Constants::INFINITE_SCORE,
+		Score beta = Constants::INFINITE_SCORE,
+		SearchContext* context = nullptr) const {
+
+		static_assert(depth < SearchContext::MAX_DEPTH);
+		if (context) {
+			context->ClearVariation(depth);
+			// Out of time, the score is ignored
+			if (context->CheckDeadline()) {
+				return 0;
+			}
+		}
 
 		// If the board is won for either side, we cannot keep looking
-		if (auto score = F(board); score == std::numeric_limits<float>::infinity() ||
-			score == -std::numeric_limits<float>::infinity()) {
+		const Score value = F(board);
+		if (const auto score = SearchScore(value, depth); IsWinScore(score)) {
 			return score;
 		}
+		// Nor if neither side can win any more
+		if (board.Drawn()) {
+			return 0;
+		}
+
+		// Has the position been searched deep enough before? Else, its best ply is a good first guess
+		uint16_t hashPly = TranspositionEntry::NO_PLY;
+		if (context) {
+			if (const auto entry = context->Probe(board.Key(), max)) {
+				if (entry->depth >= depth) {
+					const auto score = FromTableScore(entry->score, depth);
+					if (entry->bound != Bound::UPPER) alpha = std::max(alpha, score);
+					if (entry->bound != Bound::LOWER) beta = std::min(beta, score);
+					if (alpha >= beta) {
+						context->CountCutoff();
+						return score;
+					}
+				}
+				hashPly = entry->ply;
+			}
+		}
+
+		// The window the children are searched in, narrowed by the entry, which the result is a bound of
+		const Score windowAlpha = alpha;
+		const Score windowBeta = beta;
 
 		// The minimax of the next depth
-		constexpr Minimax<depth - 1, !max, F> next{};
+		constexpr BasicMinimax<BoardType, depth - 1, !max, F, false, rootDepth> next{};
 
 		// Initialize bestScore to worst value, updating as we go
-		float bestScore = max ? -std::numeric_limits<float>::infinity() :
-			std::numeric_limits<float>::infinity();
-		
-		// Do we sort the children for this depth?
-		// (To sort, we need to call Board::InRangePlies, which may be wasteful at certain depths
-		// due to the alpha-beta pruning)
-		if constexpr (depth >= Constants::PLY_LOOK_AHEAD - Constants::SORTING_DEPTH) {
-			auto order = board.InRangePlies();
-			std::sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) -> bool {
-				if constexpr (max) {
-					return F(board.Play(lhs, !max)) > F(board.Play(rhs, !max));
+		Score bestScore = max ? -Constants::INFINITE_SCORE : Constants::INFINITE_SCORE;
+		size_t bestPly = TranspositionEntry::NO_PLY;
+
+		// Searches a child, returning whether it cuts off the rest
+		[[maybe_unused]] size_t searched = 0;
+		auto search = [&](const size_t ply) -> bool {
+			// A quiet child of a node one ply above the horizon can't gain more than the margin
+			if constexpr (Constants::FUTILITY_PRUNING && depth == 1) {
+				const bool futile = max ? value + Constants::FUTILITY_MARGIN <= alpha :
+					value - Constants::FUTILITY_MARGIN >= beta;
+				if (futile && !board.Tactical(ply, Constants::TACTICAL_PIECES)) {
+					HandleChildValue(ply, max ? value + Constants::FUTILITY_MARGIN : value - Constants::FUTILITY_MARGIN,
+						bestPly, bestScore, alpha, beta);
+					return false;
 				}
-				else {
-					return F(board.Play(lhs, !max)) < F(board.Play(rhs, !max));
+			}
+
+			const auto child = board.Play(ply, !max);
+
+			// A late quiet child is searched to full depth only if the shallower search can't rule it out
+			if constexpr (Constants::LATE_MOVE_REDUCTIONS && depth >= Constants::LMR_MIN_DEPTH) {
+				if (searched++ >= Constants::LMR_FULL_MOVES && !board.Tactical(ply, Constants::TACTICAL_PIECES)) {
+					constexpr BasicMinimax<BoardType, depth - 2, !max, F, false, rootDepth> reduced{};
+					const auto score = reduced(child, alpha, beta, context);
+					if (context && context->Expired()) {
+						return true;
+					}
+					if (max ? score <= alpha : score >= beta) {
+						HandleChildValue(ply, score, bestPly, bestScore, alpha, beta);
+						return false;
+					}
 				}
-			});
+			}
+
+			// A score inside the window is exact, and the best so far: its line is the best one
+			const Score score = next(child, alpha, beta, context);
+			if (context && context->Expired()) {
+				return true;
+			}
+			if (context && alpha < score && score < beta) {
+				context->UpdateVariation(depth, ply);
+			}
+			HandleChildValue(ply, score, bestPly, bestScore, alpha, beta);
+			if constexpr (max) {
+				return bestScore >= beta;
+			}
+			else {
+				return bestScore <= alpha;
+			}
+		};
+
+		// Do we sort the children for this depth, i.e. is it within SORTING_DEPTH plies of the root?
+		// (To sort, we need to call Board::InRangePlies, which may be wasteful at certain depths
+		// due to the alpha-beta pruning)
+		constexpr bool sorted = depth + Constants::SORTING_DEPTH >= rootDepth;
+		if (sorted || context) {
+			auto order = CandidatePlies(board, !max);
+			if constexpr (sorted) {
+				std::sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) -> bool {
+					if constexpr (max) {
+						return F(board.Play(lhs, !max)) > F(board.Play(rhs, !max));
+					}
+					else {
+						return F(board.Play(lhs, !max)) < F(board.Play(rhs, !max));
+					}
+				});
+			}
+			else {
+				context->OrderByHistory(order);
+			}
+			if (context) {
+				SearchContext::Promote(order, hashPly);
+			}
 			for (size_t ply : order) {
-				HandleChildValue(next(board.Play(ply, !max), alpha, beta), bestScore, alpha, beta);
-				if constexpr (max) {
-					if (bestScore >= beta)
-						return bestScore;
+				if (search(ply)) {
+					if (context && !context->Expired()) context->RecordCutoff(ply, depth);
+					break;
 				}
-				else if (bestScore <= alpha)
-					return bestScore;
 			}
-			return bestScore;
 		}
-		// No sorting, just iterate through the "in range" children lazily
-		for (size_t ply = 0; ply < Constants::BOARD_SIZE; ++ply) {
-			if (!board.InRange(ply)) continue;
-			HandleChildValue(next(board.Play(ply, !max), alpha, beta), bestScore, alpha, beta);
-			if constexpr (max) {
-				if (bestScore >= beta)
-					return bestScore;
+		// No sorting, just iterate through the forced children, or the "in range" children lazily
+		else {
+			std::vector<size_t> forced;
+			if constexpr (Constants::THREAT_CANDIDATES) {
+				forced = board.ThreatPlies(!max);
+			}
+			for (const size_t ply : forced) {
+				if (search(ply)) break;
 			}
-			else if (bestScore <= alpha)
-				return bestScore;
+			for (size_t ply = 0; forced.empty() && ply < BoardType::SIZE; ++ply) {
+				if (!board.InRange(ply)) continue;
+				if (search(ply)) break;
+			}
+		}
+
+		if (context && !context->Expired()) {
+			const auto bound = bestScore <= windowAlpha ? Bound::UPPER :
+				bestScore >= windowBeta ? Bound::LOWER : Bound::EXACT;
+			context->Store(board.Key(), max, depth, ToTableScore(bestScore, depth), bestPly, bound);
 		}
 		return bestScore;
 	}
 private:
 
 	// Handles the result of a child minimax search
-	void HandleChildValue(const float score, float& bestScore, float& alpha, float& beta) const {
+	void HandleChildValue(const size_t child, const Score score,
+		size_t& bestChild, Score& bestScore, Score& alpha, Score& beta) const {
 		if constexpr (max) {
+			if (score > bestScore || bestChild == TranspositionEntry::NO_PLY) {
+				bestChild = child;
+			}
 			bestScore = std::max(score, bestScore);
 			alpha = std::max(alpha, bestScore);
 		}
 		else {
+			if (score < bestScore || bestChild == TranspositionEntry::NO_PLY) {
+				bestChild = child;
+			}
 			bestScore = std::min(score, bestScore);
 			beta = std::min(beta, bestScore);
 		}
@@ -92,27 +285,48 @@ private:
 
 
 // Base case partial specialization
-template<bool max, float(*F)(const Board&)>
-struct Minimax<0, max, F, false> {
-	float operator()(const Board& board, float alpha = 0.0f, float beta = 0.0f) const {
+template<typename BoardType, bool max, Score(*F)(const BoardType&), size_t rootDepth>
+struct BasicMinimax<BoardType, 0, max, F, false, rootDepth> {
+	Score operator()(const BoardType& board, Score = 0, Score = 0, SearchContext* context = nullptr) const {
+		// The leaves are the bulk of the nodes, which the deadline is counted in
+		if (context) {
+			context->CheckDeadline();
+		}
 		// Just call the function
-		return F(board);
+		return SearchScore(F(board), 0);
 	}
 };
 
 
 // Partial specialization returning best immediate child of tree (value agnostic)
-template<size_t depth, bool max, float(*F)(const Board&)>
-struct Minimax<depth, max, F, true> {
-	size_t operator()(const Board& board,
-		float alpha = -std::numeric_limits<float>::infinity(),
-		float beta = std::numeric_limits<float>::infinity()) const {
+template<typename BoardType, size_t depth, bool max, Score(*F)(const BoardType&)>
+struct BasicMinimax<BoardType, depth, max, F, true, depth> {
+	size_t operator()(const BoardType& board,
+		Score alpha = -Constants::INFINITE_SCORE,
+		Score beta = Constants::INFINITE_SCORE,
+		SearchContext* context = nullptr,
+		SearchProgress* progress = nullptr,
+		const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) const {
 
 		static_assert(depth != 0); // There is no child to return
+		static_assert(depth < SearchContext::MAX_DEPTH);
+		if (context) {
+			context->ClearVariation(depth);
+		}
 
 		// The policy is just to always sort at first depth, because otherwise the result can be strange
 		// (e.g. not finishing the game when it can waste turns and still win later)
-		auto order = board.InRangePlies();
+		auto order = CandidatePlies(board, !max);
+
+		// A full board has no ply at all, which is answered as SIZE (no cell)
+		if (order.empty()) {
+			return BoardType::SIZE;
+		}
+		// A drawn board has nothing left to search for
+		if (board.Drawn()) {
+			return order.front();
+		}
+
 		std::sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) -> bool {
 			if constexpr (max) {
 				return F(board.Play(lhs, !max)) > F(board.Play(rhs, !max));
@@ -122,34 +336,54 @@ struct Minimax<depth, max, F, true> {
 			}
 		});
 
-		constexpr Minimax<depth - 1, !max, F, false> next{}; // Next depth is child-agnostic
+		// The best ply of an earlier search of the position is searched first, which narrows the window sooner
+		if (context) {
+			if (const auto entry = context->Probe(board.Key(), max)) {
+				SearchContext::Promote(order, entry->ply);
+			}
+		}
 
-		float bestScore = max ? -std::numeric_limits<float>::infinity() :
-			std::numeric_limits<float>::infinity();
-		auto bestChild = order.front(); // First born favoritism
+		constexpr BasicMinimax<BoardType, depth - 1, !max, F, false, depth> next{}; // Next depth is child-agnostic
 
-		// Search the children
-		for (const auto ply : order) {
-			HandleChildValue(ply, next(board.Play(ply, !max), alpha, beta),
-				bestChild, bestScore, alpha, beta);
+		Score bestScore = max ? -Constants::INFINITE_SCORE : Constants::INFINITE_SCORE;
+		auto bestChild = order.front(); // First born favoritism
+		if (progress) {
+			progress->Publish({ bestChild, SearchScore(F(board.Play(bestChild, !max)), depth - 1), depth, 0, order.size(), 0 });
 		}
 
-		// If it's lost to a perfect player no matter what,
-		// try to atleast survive the next move (no strange giving up-behavior)
-		if constexpr (depth != 2) {
-			if ((max && bestScore == -std::numeric_limits<float>::infinity()) ||
-				(!max && bestScore == std::numeric_limits<float>::infinity())) {
-				constexpr Minimax<2, !max, F, true> desperateTry{};
-				return desperateTry(board);
+		// Search the children. A better score than the best so far is above alpha, so it is exact
+		for (size_t i = 0; i < order.size(); ++i) {
+			const auto ply = order[i];
+			const Score score = next(board.Play(ply, !max), alpha, beta, context);
+			// Out of time within the child, its score is unknown
+			if (context && context->Expired()) {
+				return bestChild;
+			}
+			if (context && (max ? score > bestScore : score < bestScore)) {
+				context->UpdateVariation(depth, ply);
+			}
+			HandleChildValue(ply, score, bestChild, bestScore, alpha, beta);
+			if (progress) {
+				progress->Publish({ bestChild, bestScore, depth, i + 1, order.size(), 0 });
+			}
+
+			// Out of time, the best child so far is the answer. It is not stored, as the others are unknown
+			if (i + 1 < order.size() && std::chrono::steady_clock::now() >= deadline) {
+				return bestChild;
 			}
 		}
 
+		// If it's lost to a perfect player no matter what, the slowest loss scored best, so it
+		// still tries to survive as long as it can (no strange giving up-behavior, and no second search)
+		if (context) {
+			context->Store(board.Key(), max, depth, ToTableScore(bestScore, depth), bestChild, Bound::EXACT);
+		}
 		return bestChild;
 	}
 private:
 	// Handle minimax search of child, retaining the knowledge of which child is best
-	void HandleChildValue(const size_t child, const float score,
-		size_t& bestChild, float& bestScore, float& alpha, float& beta) const {
+	void HandleChildValue(const size_t child, const Score score,
+		size_t& bestChild, Score& bestScore, Score& alpha, Score& beta) const {
 		if constexpr (max) {
 			if (score > bestScore) {
 				bestScore = score;
@@ -165,4 +399,185 @@ private:
 			beta = std::min(beta, bestScore);
 		}
 	}
-};
\ No newline at end of file
+};
+
+
+// The lines best root plies, best first, with their scores and principal variations (multi-PV).
+// A child only needs to beat the worst of the best lines so far, so it is searched with that as its window
+// (the best line's window in a single-PV search): a child which fails low can't be among them. With lines = 1,
+// it searches the same as the search returning the best child
+template<typename BoardType, size_t depth, bool max, Score(*F)(const BoardType&)>
+struct BasicMultiPV {
+	static_assert(depth != 0); // There is no child to return
+
+	std::vector<ScoredPly> operator()(const BoardType& board, const size_t lines,
+		SearchContext* context = nullptr, SearchProgress* progress = nullptr) const {
+
+		// Ordered like the search returning the best child
+		auto order = CandidatePlies(board, !max);
+		if (order.empty()) {
+			return {};
+		}
+		if (board.Drawn()) {
+			return { { order.front(), 0, { order.front() } } };
+		}
+		std::sort(order.begin(), order.end(), [&](const size_t lhs, const size_t rhs) -> bool {
+			if constexpr (max) {
+				return F(board.Play(lhs, !max)) > F(board.Play(rhs, !max));
+			}
+			else {
+				return F(board.Play(lhs, !max)) < F(board.Play(rhs, !max));
+			}
+		});
+		if (context) {
+			if (const auto entry = context->Probe(board.Key(), max)) {
+				SearchContext::Promote(order, entry->ply);
+			}
+		}
+
+		constexpr BasicMinimax<BoardType, depth - 1, !max, F, false, depth> next{};
+		auto better = [](const ScoredPly& lhs, const ScoredPly& rhs) {
+			return max ? lhs.score > rhs.score : lhs.score < rhs.score;
+		};
+
+		// The best lines so far, best first
+		std::vector<ScoredPly> best;
+		best.reserve(lines + 1);
+		if (progress) {
+			progress->Publish({ order.front(), SearchScore(F(board.Play(order.front(), !max)), depth - 1), depth, 0,
+				order.size(), 0 });
+		}
+		for (size_t i = 0; i < order.size(); ++i) {
+			const auto ply = order[i];
+			if (progress && i) {
+				progress->Publish({ best.front().ply, best.front().score, depth, i, order.size(), 0 });
+			}
+			// The window is open only above the worst of the best lines, once there are enough of them
+			const bool full = best.size() >= lines;
+			const Score alpha = max && full ? best.back().score : -Constants::INFINITE_SCORE;
+			const Score beta = !max && full ? best.back().score : Constants::INFINITE_SCORE;
+			const auto child = board.Play(ply, !max);
+			const Score score = next(child, alpha, beta, context);
+			if (max ? score <= alpha : score >= beta) {
+				continue;
+			}
+
+			// The child's search is exact, and has left its line behind
+			ScoredPly line{ ply, score, { ply } };
+			if (context) {
+				const auto rest = context->Variation(depth - 1);
+				line.variation.insert(line.variation.end(), rest.begin(), rest.end());
+			}
+			best.insert(std::upper_bound(best.begin(), best.end(), line, better), std::move(line));
+			if (best.size() > lines) {
+				best.pop_back();
+			}
+		}
+		if (progress) {
+			progress->Publish({ best.front().ply, best.front().score, depth, order.size(), order.size(), 0 });
+		}
+
+		if (context) {
+			context->Store(board.Key(), max, depth, ToTableScore(best.front().score, depth), best.front().ply, Bound::EXACT);
+		}
+		return best;
+	}
+};
+
+// Multi-PV search on the configured board
+template<size_t depth, bool max, Score(*F)(const Board&)>
+using MultiPV = BasicMultiPV<Board, depth, max, F>;
+
+// What an iterative deepening search found
+struct DeepeningResult {
+	size_t ply;
+	// The depth of the iteration which chose the ply, and whether it ended in time (else its root may
+	// have skipped plies)
+	size_t depth;
+	bool finished;
+	// The iterations before that one in a row which chose the same ply
+	size_t stable;
+	// The principal variation of that iteration: the ply, and the best replies it expects
+	std::vector<size_t> variation;
+};
+
+// Searches the board 1, 2, ... maxDepth plies deep, for as long as the allocation allows: it begins no iteration
+// after the target (shortened once the best ply has been stable, lengthened after it changed), and the search stops
+// at the maximum, even within a root child (given a context, see SearchContext::SetDeadline), answering the best of
+// the root's children so far. That is only taken over the previous iteration's ply if the root searched that one
+// first (through the context's transposition table, if it still has the root's entry), so that it is at least as good.
+// The first iteration always finishes, so a single ply (see AllocateTime) is answered at once
+template<typename BoardType, size_t maxDepth, bool max, Score(*F)(const BoardType&)>
+struct BasicIterativeDeepening {
+	static_assert(maxDepth != 0); // There is no child to return
+
+	DeepeningResult operator()(const BoardType& board, const TimeAllocation& allocation,
+		SearchContext* context = nullptr, SearchProgress* progress = nullptr) const {
+		const auto begin = std::chrono::steady_clock::now();
+		DeepeningResult result{};
+		Deepen(board, allocation, begin, context, progress, result, std::make_index_sequence<maxDepth>{});
+		return result;
+	}
+
+private:
+	// Runs the iterations in order, until one of them says to stop
+	template<size_t... depths>
+	static void Deepen(const BoardType& board, const TimeAllocation& allocation,
+		const std::chrono::steady_clock::time_point begin, SearchContext* context, SearchProgress* progress,
+		DeepeningResult& result, std::index_sequence<depths...>) {
+		(Iterate<depths + 1>(board, allocation, begin, context, progress, result) && ...);
+	}
+
+	// Searches depth plies deep, returning whether there is time for another iteration
+	template<size_t depth>
+	static bool Iterate(const BoardType& board, const TimeAllocation& allocation,
+		const std::chrono::steady_clock::time_point begin, SearchContext* context, SearchProgress* progress,
+		DeepeningResult& result) {
+		constexpr BasicMinimax<BoardType, depth, max, F, true> root{};
+		constexpr auto infinity = Constants::INFINITE_SCORE;
+
+		// Does the root search the previous iteration's ply first (see its Promote)?
+		bool previousFirst = false;
+		if (context && depth > 1) {
+			const auto entry = context->Probe(board.Key(), max);
+			previousFirst = entry && entry->ply == result.ply;
+		}
+
+		const auto deadline = depth == 1 ? std::chrono::steady_clock::time_point::max() : begin + allocation.maximum;
+		if (context) {
+			context->SetDeadline(deadline);
+		}
+		const auto ply = root(board, -infinity, infinity, context, progress, deadline);
+		const bool expired = context && context->Expired();
+		if (context) {
+			context->SetDeadline(std::chrono::steady_clock::time_point::max());
+		}
+		const auto now = std::chrono::steady_clock::now();
+		const bool finished = !expired && now < deadline;
+
+		// An unfinished iteration which didn't search the previous ply first may not have searched it at all
+		if (!finished && !previousFirst) {
+			return false;
+		}
+
+		result.stable = depth > 1 && ply == result.ply ? result.stable + 1 : 0;
+		result.ply = ply;
+		result.depth = depth;
+		result.finished = finished;
+		result.variation = context ? context->Variation(depth) : std::vector<size_t>{};
+		if (result.variation.empty()) {
+			result.variation = { ply };
+		}
+		if (!finished) {
+			return false;
+		}
+
+		const auto scale = result.stable >= Constants::CLOCK_STABLE_ITERATIONS ? Constants::CLOCK_STABLE_FACTOR :
+			depth > 1 && !result.stable ? Constants::CLOCK_UNSTABLE_FACTOR : 1.0;
+		return now - begin < std::chrono::duration<double, std::milli>(allocation.target) * scale;
+	}
+};
+
+// Iterative deepening search on the configured board
+template<size_t maxDepth, bool max, Score(*F)(const Board&)>
+using IterativeDeepening = BasicIterativeDeepening<Board, maxDepth, max, F>;
\ No newline at end of file
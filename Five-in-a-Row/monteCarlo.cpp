@@ -0,0 +1,294 @@
+#include "monteCarlo.hpp"
+#include "minimax.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <variant>
+#include <cmath>
+
+// The random in-range cells a playout tries before listing them all
+constexpr size_t PLAYOUT_TRIES = 32;
+
+// SplitMix64, stepping the thread's random state
+uint64_t NextRandom(uint64_t& state) {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+MonteCarlo::MonteCarlo(const size_t nodeBits) : nodes(size_t{ 1 } << nodeBits) {
+	Clear();
+}
+
+template <size_t width, size_t height>
+MonteCarloResult MonteCarlo::Search(const BasicBoard<width, height>& board, const bool blue,
+	const MonteCarloBudget budget, const size_t threads, SearchProgress* progress) {
+	const auto begin = std::chrono::steady_clock::now();
+	const auto recycled = Recycle(board, blue);
+	if (nodes[0].children == LEAF && !Expand(nodes[0], board, blue)) {
+		Clear();
+		Expand(nodes[0], board, blue);
+	}
+
+	// Every thread iterates until the playouts or the time run out
+	playouts = 0;
+	const auto deadline = budget.time == std::chrono::milliseconds::max() ?
+		std::chrono::steady_clock::time_point::max() : begin + budget.time;
+	// The first thread publishes the progress, now and then
+	auto work = [&](uint64_t random, const bool publishing) {
+		for (uint64_t iterations = 0; playouts.fetch_add(1, std::memory_order_relaxed) < budget.playouts &&
+			std::chrono::steady_clock::now() < deadline; ++iterations) {
+			if (publishing && iterations % PROGRESS_INTERVAL == 0) {
+				progress->Publish({ nodes[MostVisited()].ply, 0, 0,
+					std::min<uint64_t>(playouts.load(std::memory_order_relaxed), budget.playouts), 0, 0 });
+			}
+			Iterate(board, blue, random);
+		}
+	};
+	const size_t workerCount = threads ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+	if (workerCount == 1) {
+		work(board.Key(), progress != nullptr);
+	}
+	else {
+		std::vector<std::jthread> workers;
+		for (size_t t = 0; t < workerCount; ++t) {
+			workers.emplace_back(work, board.Key() + t, progress && t == 0);
+		}
+	}
+
+	// The most visited child is the most trusted one
+	const auto& parent = nodes[0];
+	const auto& best = nodes[MostVisited()];
+	if (progress) {
+		progress->Publish({ best.ply, 0, 0, std::min<uint64_t>(playouts, budget.playouts), 0, 0 });
+	}
+	root = board;
+	rootBlue = blue;
+
+	return { best.ply, parent.visits, best.visits ? best.reward / (2.0 * best.visits) : 0.0,
+		std::min<uint64_t>(playouts, budget.playouts), std::min<uint64_t>(used, nodes.size()), recycled,
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() };
+}
+
+uint32_t MonteCarlo::MostVisited() {
+	const auto& parent = nodes[0];
+	uint32_t best = parent.children;
+	uint32_t bestVisits = 0, bestReward = 0;
+	for (uint32_t child = parent.children; child < parent.children + parent.childCount; ++child) {
+		const auto visits = std::atomic_ref(nodes[child].visits).load(std::memory_order_relaxed);
+		const auto reward = std::atomic_ref(nodes[child].reward).load(std::memory_order_relaxed);
+		if (visits > bestVisits || (visits == bestVisits && reward > bestReward)) {
+			best = child;
+			bestVisits = visits;
+			bestReward = reward;
+		}
+	}
+	return best;
+}
+
+template <size_t width, size_t height>
+void MonteCarlo::Iterate(const BasicBoard<width, height>& root, bool blue, uint64_t& random) {
+	// The nodes descended through, from the root
+	thread_local std::vector<uint32_t> path;
+	path.clear();
+
+	auto board = root;
+	uint32_t index = 0;
+	std::atomic_ref(nodes[0].visits).fetch_add(Constants::MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+	path.push_back(0);
+
+	// The half points of the result for the color which played the last node's ply
+	uint32_t result;
+	while (true) {
+		auto& node = nodes[index];
+		if (board.RedWin() || board.BlueWin()) {
+			result = 2;
+			break;
+		}
+		if (board.Drawn()) {
+			result = 1;
+			break;
+		}
+
+		// A leaf is expanded, unless the tree is full or another thread is expanding it: then it is played out
+		auto children = std::atomic_ref(node.children).load(std::memory_order_acquire);
+		if (children == LEAF && Expand(node, board, blue)) {
+			children = node.children;
+		}
+		if (children == LEAF || children == EXPANDING) {
+			result = Playout(board, blue, random);
+			break;
+		}
+
+		// The child with the best upper confidence bound, or the first one not visited yet
+		const auto logVisits = std::log(static_cast<float>(std::atomic_ref(node.visits).load(std::memory_order_relaxed)));
+		uint32_t best = children;
+		float bestBound = -1.0f;
+		for (uint32_t child = children; child < children + node.childCount; ++child) {
+			const auto visits = std::atomic_ref(nodes[child].visits).load(std::memory_order_relaxed);
+			if (visits == 0) {
+				best = child;
+				break;
+			}
+			const auto reward = std::atomic_ref(nodes[child].reward).load(std::memory_order_relaxed);
+			const auto bound = reward / (2.0f * visits) + Constants::MCTS_EXPLORATION * std::sqrt(logVisits / visits);
+			if (bound > bestBound) {
+				bestBound = bound;
+				best = child;
+			}
+		}
+
+		const auto visited = std::atomic_ref(nodes[best].visits).fetch_add(Constants::MCTS_VIRTUAL_LOSS,
+			std::memory_order_relaxed);
+		board = board.Play(nodes[best].ply, blue);
+		blue = !blue;
+		index = best;
+		path.push_back(index);
+
+		// A new child is played out right away
+		if (visited == 0) {
+			if (board.RedWin() || board.BlueWin()) {
+				result = 2;
+			}
+			else {
+				result = board.Drawn() ? 1 : Playout(board, blue, random);
+			}
+			break;
+		}
+	}
+
+	// Count the result, alternating the color, and take the virtual losses back
+	for (auto it = path.rbegin(); it != path.rend(); ++it) {
+		std::atomic_ref(nodes[*it].visits).fetch_sub(Constants::MCTS_VIRTUAL_LOSS - 1, std::memory_order_relaxed);
+		std::atomic_ref(nodes[*it].reward).fetch_add(result, std::memory_order_relaxed);
+		result = 2 - result;
+	}
+}
+
+template <size_t width, size_t height>
+bool MonteCarlo::Expand(Node& node, const BasicBoard<width, height>& board, const bool blue) {
+	auto children = LEAF;
+	if (!std::atomic_ref(node.children).compare_exchange_strong(children, EXPANDING, std::memory_order_acquire)) {
+		return false;
+	}
+
+	const auto plies = CandidatePlies(board, blue);
+	const auto count = static_cast<uint32_t>(plies.size());
+	if (used.load(std::memory_order_relaxed) + count > nodes.size()) {
+		std::atomic_ref(node.children).store(LEAF, std::memory_order_release);
+		return false;
+	}
+	const auto first = used.fetch_add(count, std::memory_order_relaxed);
+	if (first + count > nodes.size()) {
+		std::atomic_ref(node.children).store(LEAF, std::memory_order_release);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		nodes[first + i] = { 0, 0, LEAF, 0, static_cast<uint16_t>(plies[i]) };
+	}
+	node.childCount = static_cast<uint16_t>(count);
+	std::atomic_ref(node.children).store(first, std::memory_order_release);
+	return true;
+}
+
+template <size_t width, size_t height>
+uint32_t MonteCarlo::Playout(BasicBoard<width, height> board, bool blue, uint64_t& random) {
+	const bool last = !blue;
+
+	// Whether the board is known to have no threats. A threat takes three pieces in a "five", so only
+	// a tactical ply (see Board::Tactical) can make one, and the threats need only be looked for after it
+	bool quiet = false;
+	while (true) {
+		if (board.RedWin()) return last ? 0 : 2;
+		if (board.BlueWin()) return last ? 2 : 0;
+		if (board.Drawn()) return 1;
+
+		// A ply forced by a threat, else a random in-range one
+		std::optional<size_t> ply;
+		if constexpr (Constants::MCTS_HEURISTIC_PLAYOUTS) {
+			if (!quiet) {
+				const auto forced = board.ThreatPlies(blue);
+				quiet = forced.empty();
+				if (!quiet) {
+					ply = forced[NextRandom(random) % forced.size()];
+				}
+			}
+		}
+		for (size_t i = 0; !ply && i < PLAYOUT_TRIES; ++i) {
+			if (const auto pos = NextRandom(random) % board.SIZE; board.InRange(pos)) {
+				ply = pos;
+			}
+		}
+		if (!ply) {
+			const auto plies = board.InRangePlies();
+			ply = plies[NextRandom(random) % plies.size()];
+		}
+
+		if constexpr (Constants::MCTS_HEURISTIC_PLAYOUTS) {
+			quiet = quiet && !board.Tactical(*ply, 2);
+		}
+		board = board.Play(*ply, blue);
+		blue = !blue;
+	}
+}
+
+template <size_t width, size_t height>
+uint64_t MonteCarlo::Recycle(const BasicBoard<width, height>& board, const bool blue) {
+	using BoardType = BasicBoard<width, height>;
+
+	// Follow the plies played since the previous search down the tree
+	std::optional<uint32_t> index;
+	if (root && std::holds_alternative<BoardType>(*root)) {
+		auto previous = std::get<BoardType>(*root);
+		auto mover = rootBlue;
+		index = 0;
+		while (index && (previous.Key() != board.Key() || mover != blue)) {
+			const auto& node = nodes[*index];
+			const auto color = mover ? CellState::BLUE : CellState::RED;
+			index.reset();
+			for (uint32_t child = node.children; node.children != LEAF && child < node.children + node.childCount; ++child) {
+				if (previous.At(nodes[child].ply) == CellState::EMPTY && board.At(nodes[child].ply) == color) {
+					index = child;
+					previous = previous.Play(nodes[child].ply, mover);
+					mover = !mover;
+					break;
+				}
+			}
+		}
+	}
+
+	if (!index) {
+		Clear();
+		return 0;
+	}
+	if (*index == 0) {
+		return used;
+	}
+
+	// Copy the subtree breadth first, which keeps every node's children consecutive
+	std::vector<Node> kept{ nodes[*index] };
+	for (size_t i = 0; i < kept.size(); ++i) {
+		if (const auto children = kept[i].children; children != LEAF) {
+			kept[i].children = static_cast<uint32_t>(kept.size());
+			kept.insert(kept.end(), nodes.begin() + children, nodes.begin() + children + kept[i].childCount);
+		}
+	}
+	std::copy(kept.begin(), kept.end(), nodes.begin());
+	used = static_cast<uint32_t>(kept.size());
+	return kept.size();
+}
+
+void MonteCarlo::Clear() {
+	nodes[0] = { 0, 0, LEAF, 0, 0 };
+	used = 1;
+	root.reset();
+}
+
+template MonteCarloResult MonteCarlo::Search<15, 15>(const BasicBoard<15, 15>&, const bool, const MonteCarloBudget, const size_t,
+	SearchProgress*);
+template MonteCarloResult MonteCarlo::Search<19, 19>(const BasicBoard<19, 19>&, const bool, const MonteCarloBudget, const size_t,
+	SearchProgress*);
+template MonteCarloResult MonteCarlo::Search<7, 7>(const BasicBoard<7, 7>&, const bool, const MonteCarloBudget, const size_t,
+	SearchProgress*);
\ No newline at end of file
@@ -0,0 +1,106 @@
+// This header defines the Monte Carlo tree search, the alternative to Minimax which needs no goal function.
+// It grows a tree of plies from the position by UCT: every iteration descends the tree, choosing the child with
+// the best upper confidence bound, expands the node it ends at, plays the game out from there, and counts the
+// result on the way back up. The ply played is the most visited child of the root. The tree expands the plies of
+// Board::CandidatePlies (with Constants::THREAT_CANDIDATES, else Board::InRangePlies). The playouts play random
+// in-range cells, or with Constants::MCTS_HEURISTIC_PLAYOUTS a ply forced by a threat (see Board::ThreatPlies) first.
+
+// The threads share one tree (tree parallelism). A thread adds a virtual loss to every node it descends through
+// and removes it when it counts the result, so that the others explore elsewhere meanwhile. The nodes are
+// allocated from a fixed arena, and the tree stops growing when it is full. When the next search's position
+// follows from the previous one's, the subtree of the plies played since is kept (recycled) and the rest freed.
+
+#pragma once
+
+#include "board.hpp"
+#include "searchProgress.hpp"
+
+#include <vector>
+#include <optional>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+
+// The most a search may do before playing its best ply
+struct MonteCarloBudget {
+	uint64_t playouts = std::numeric_limits<uint64_t>::max();
+	std::chrono::milliseconds time = std::chrono::milliseconds::max();
+};
+
+struct MonteCarloResult {
+	size_t ply;
+	// The root's visits and the share of them that the ply won (a draw is half a win)
+	uint64_t visits;
+	double winRate;
+	// The playouts of this search
+	uint64_t playouts;
+	// The nodes of the tree, and how many of them were kept from the previous search
+	uint64_t nodes;
+	uint64_t recycled;
+	double milliseconds;
+};
+
+class MonteCarlo {
+public:
+	// A tree of at most 2^nodeBits nodes
+	explicit MonteCarlo(const size_t nodeBits = Constants::MCTS_NODE_BITS);
+
+	// Returns the best ply for the color to move on the board (of any instantiated size), searched until
+	// the budget runs out, on threads threads (0 for one per core). The board must have an empty cell.
+	// The most visited ply so far is published to the progress, if any, with the playouts (and no score)
+	template <size_t width, size_t height>
+	MonteCarloResult Search(const BasicBoard<width, height>& board, const bool blue, const MonteCarloBudget budget,
+		const size_t threads = Constants::MCTS_THREADS, SearchProgress* progress = nullptr);
+
+	// Frees the tree. Call it when pieces are removed from the board, i.e. on undo and reset
+	void Clear();
+
+private:
+	// The child index of a node which isn't expanded yet, and of one which a thread is expanding
+	static constexpr uint32_t LEAF = 0;
+	static constexpr uint32_t EXPANDING = std::numeric_limits<uint32_t>::max();
+	// The iterations of the publishing thread between two publications of the progress
+	static constexpr uint64_t PROGRESS_INTERVAL = 256;
+
+	// The counters are updated by every thread, through std::atomic_ref
+	struct Node {
+		// The times the node was descended through, and the virtual losses of the threads below it
+		uint32_t visits;
+		// The half points the ply of the node won for the color which played it
+		uint32_t reward;
+		// The index of the first child, LEAF or EXPANDING. The children of a node are consecutive
+		uint32_t children;
+		uint16_t childCount;
+		uint16_t ply;
+	};
+
+	// Returns the index of the root's most visited child (the one with the most reward among equals),
+	// which may be read while the threads search
+	uint32_t MostVisited();
+
+	// Descends the tree from the root, expands it and plays out once, on the thread's random state
+	template <size_t width, size_t height>
+	void Iterate(const BasicBoard<width, height>& root, const bool blue, uint64_t& random);
+
+	// Allocates the children of the node, returning whether there was room for them
+	template <size_t width, size_t height>
+	bool Expand(Node& node, const BasicBoard<width, height>& board, const bool blue);
+
+	// Plays the board out at random, returning the half points it wins for the color which just played
+	template <size_t width, size_t height>
+	static uint32_t Playout(BasicBoard<width, height> board, const bool blue, uint64_t& random);
+
+	// Makes the node of the board the root if it follows from the previous root, else empties the tree.
+	// Returns the nodes kept
+	template <size_t width, size_t height>
+	uint64_t Recycle(const BasicBoard<width, height>& board, const bool blue);
+
+	std::vector<Node> nodes;
+	std::atomic<uint32_t> used{};
+	std::atomic<uint64_t> playouts{};
+
+	// The position of the root, and its color to move
+	std::optional<AnyBoard> root;
+	bool rootBlue{};
+};
\ No newline at end of file
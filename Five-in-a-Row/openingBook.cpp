@@ -0,0 +1,58 @@
+#include "openingBook.hpp"
+
+#include <stdexcept>
+#include <format>
+#include <fstream>
+#include <cstring>
+
+OpeningBook::OpeningBook(const std::filesystem::path& path) : file(path) {
+	const auto bytes = file.Bytes();
+	if (bytes.empty()) {
+		return;
+	}
+
+	Header header;
+	if (bytes.size() < sizeof(Header)) {
+		throw std::runtime_error(std::format("Bad opening book {}: too short for a header", path.string()));
+	}
+	std::memcpy(&header, bytes.data(), sizeof(Header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+		throw std::runtime_error(std::format("Bad opening book {}: not a version {} book", path.string(), VERSION));
+	}
+	// Divided, since a corrupt count may overflow the size it implies
+	const auto entryBytes = bytes.size() - sizeof(Header);
+	if (entryBytes % sizeof(Entry) != 0 || header.count != entryBytes / sizeof(Entry)) {
+		throw std::runtime_error(std::format("Bad opening book {}: {} bytes for {} entries",
+			path.string(), bytes.size(), header.count));
+	}
+
+	// The mapping is page aligned, and the header keeps the entries aligned
+	static_assert(sizeof(Header) % alignof(Entry) == 0);
+	bookWidth = header.width;
+	bookHeight = header.height;
+	entries = { reinterpret_cast<const Entry*>(bytes.data() + sizeof(Header)), static_cast<size_t>(header.count) };
+}
+
+size_t OpeningBook::Size() const {
+	return entries.size();
+}
+
+uint64_t OpeningBook::Key(const CanonicalKey canonical, const bool blue) {
+	return canonical.key ^ (blue ? BLUE_TO_MOVE : 0);
+}
+
+void OpeningBook::Write(const std::filesystem::path& path, const std::span<const Entry> entries) {
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.width = static_cast<uint32_t>(Board::WIDTH);
+	header.height = static_cast<uint32_t>(Board::HEIGHT);
+	header.count = entries.size();
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	out.write(reinterpret_cast<const char*>(entries.data()), entries.size_bytes());
+	if (!out) {
+		throw std::runtime_error(std::format("Could not write opening book {}", path.string()));
+	}
+}
\ No newline at end of file
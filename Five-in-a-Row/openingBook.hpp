@@ -0,0 +1,161 @@
+// This header defines the opening book: the computer's plies for the first few positions of a game,
+// searched offline (deeper than in game), so that they are answered in microseconds during the game
+
+// The book file is a Header followed by Entries sorted by key, in the machine's byte order.
+// An entry's key is the canonical key of a position (see Board::Canonical) mixed with the color to move,
+// so symmetric positions share one entry, whose ply is stored for the canonical form.
+// The file is memory-mapped as is, so opening it costs nothing but validating the header,
+// and a lookup is a binary search
+
+#pragma once
+
+#include "board.hpp"
+#include "minimax.hpp"
+#include "mappedFile.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+#include <span>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <unordered_set>
+#include <cstdint>
+
+class OpeningBook {
+public:
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint64_t count;
+	};
+
+	struct Entry {
+		uint64_t key;
+		// The ply, on the canonical form of the position
+		uint32_t ply;
+		// The depth it was searched to
+		uint32_t depth;
+	};
+
+	// An empty book
+	OpeningBook() = default;
+
+	// Maps the book at path. A missing file is an empty book, a bad one throws
+	explicit OpeningBook(const std::filesystem::path& path);
+
+	// Returns the book's ply for the color on the board, if it has one
+	template <size_t width, size_t height>
+	std::optional<size_t> Lookup(const BasicBoard<width, height>& board, const bool blue) const;
+
+	// Returns the number of entries in the book
+	size_t Size() const;
+
+	// Returns the key of a position with the color to move
+	static uint64_t Key(const CanonicalKey canonical, const bool blue);
+
+	// Searches every position of the opening tree with fewer than pieces pieces in which red is to move,
+	// on the given number of threads, with the minimax of depth and F (which must be threadsafe).
+	// In the tree, red plays the searched plies and blue any ply "in range" (or any at all on an empty board).
+	// Symmetric positions are searched once. Returns the entries sorted by key
+	template <size_t depth, Score(*F)(const Board&)>
+	static std::vector<Entry> Search(const size_t pieces, const size_t threads);
+
+	// Writes the entries (sorted by key) as a book for the configured board
+	static void Write(const std::filesystem::path& path, const std::span<const Entry> entries);
+
+private:
+	static constexpr char MAGIC[4] = { '5', 'B', 'O', 'K' };
+	static constexpr uint32_t VERSION = 1;
+
+	// Mixed into the keys of positions in which blue is to move
+	static constexpr uint64_t BLUE_TO_MOVE = 0x9E3779B97F4A7C15ull;
+
+	MappedFile file;
+	// The dimensions of the book's board
+	size_t bookWidth{};
+	size_t bookHeight{};
+	std::span<const Entry> entries;
+};
+
+template <size_t width, size_t height>
+std::optional<size_t> OpeningBook::Lookup(const BasicBoard<width, height>& board, const bool blue) const {
+	if (width != bookWidth || height != bookHeight) {
+		return {};
+	}
+
+	const auto canonical = board.Canonical();
+	const auto key = Key(canonical, blue);
+	const auto entry = std::lower_bound(entries.begin(), entries.end(), key,
+		[](const Entry& entry, const uint64_t key) { return entry.key < key; });
+	if (entry == entries.end() || entry->key != key) {
+		return {};
+	}
+
+	// Map the ply back from the canonical form, and don't trust it blindly in case of a key collision
+	const auto ply = BasicBoard<width, height>::InverseTransform(entry->ply, canonical.symmetry);
+	if (board.At(ply) != CellState::EMPTY) {
+		return {};
+	}
+	return ply;
+}
+
+template <size_t depth, Score(*F)(const Board&)>
+std::vector<OpeningBook::Entry> OpeningBook::Search(const size_t pieces, const size_t threads) {
+	constexpr BasicMinimax<Board, depth, true, F, true> redComputer{};
+
+	std::vector<Entry> result;
+
+	// The positions with the current number of pieces, and whether blue is to move. Either color may start
+	std::vector<std::pair<Board, bool>> positions{ { Board{}, false }, { Board{}, true } };
+	for (size_t count = 0; count < pieces && !positions.empty(); ++count) {
+		std::vector<std::pair<Board, bool>> next;
+		std::unordered_set<uint64_t> seen;
+		auto push = [&](const Board& board, const bool blue) {
+			if (!board.RedWin() && !board.BlueWin() && seen.insert(Key(board.Canonical(), blue)).second) {
+				next.emplace_back(board, blue);
+			}
+		};
+
+		// Blue's positions branch into every reply, red's are to be searched
+		std::vector<Board> red;
+		for (const auto& [board, blue] : positions) {
+			if (!blue) {
+				red.push_back(board);
+				continue;
+			}
+			for (size_t ply = 0; ply < Board::SIZE; ++ply) {
+				if (board.Empty() || board.InRange(ply)) push(board.Play(ply, true), false);
+			}
+		}
+
+		// Search red's positions in parallel. Each search is a lot of work, so a shared counter is enough
+		std::vector<size_t> plies(red.size());
+		std::atomic<size_t> index{};
+		{
+			std::vector<std::jthread> workers;
+			for (size_t i = 0; i < std::max<size_t>(threads, 1); ++i) {
+				workers.emplace_back([&]() {
+					for (size_t j; (j = index.fetch_add(1)) < red.size();) {
+						plies[j] = redComputer(red[j]);
+					}
+				});
+			}
+		}
+
+		for (size_t i = 0; i < red.size(); ++i) {
+			const auto canonical = red[i].Canonical();
+			result.push_back({ Key(canonical, false),
+				static_cast<uint32_t>(Board::Transform(plies[i], canonical.symmetry)), static_cast<uint32_t>(depth) });
+			push(red[i].Play(plies[i], false), true);
+		}
+
+		positions = std::move(next);
+	}
+
+	std::sort(result.begin(), result.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.key < rhs.key; });
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+// This header contains the definition of the pattern goal function, an alternative to GoalFunction
+// Instead of counting uncontested "fives", it sums a compile-time pattern table over every six-cell window
+// of every line, so it also knows an open four or three from a blocked one (see Constants::PATTERN_TABLE).
+// The board keeps that sum up to date as pieces are played, so evaluating it is constant time
+#pragma once
+
+#include "board.hpp"
+
+#include <algorithm>
+
+template <size_t width, size_t height>
+Score PatternGoalFunction(const BasicBoard<width, height>& board) {
+	if (board.RedWin()) return Constants::WIN_SCORE;
+	if (board.BlueWin()) return -Constants::WIN_SCORE;
+	return std::clamp(board.PatternScore(), -Constants::MAX_HEURISTIC_SCORE + 1, Constants::MAX_HEURISTIC_SCORE - 1);
+}
\ No newline at end of file
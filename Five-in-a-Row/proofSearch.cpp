@@ -0,0 +1,274 @@
+#include "proofSearch.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <bit>
+
+// Mixed into the keys of positions in which the attacker is blue, and in which the defender is to move
+constexpr uint64_t BLUE_ATTACKER = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t DEFENDING = 0xD6E8FEB86659FD93ull;
+
+// How many positions are expanded between looks at the clock
+constexpr uint64_t CLOCK_INTERVAL = 1024;
+
+// The budget of every root ply in the first round of SolveParallel, which grows fourfold every round
+constexpr uint64_t FIRST_ROUND_NODES = 256;
+
+template <size_t width, size_t height>
+BasicProofSearch<width, height>::BasicProofSearch(const size_t tableBits) : table(size_t{ 1 } << tableBits) {}
+
+template <size_t width, size_t height>
+uint64_t BasicProofSearch<width, height>::Key(const BoardType& board, const bool attacker, const bool attacking) {
+	return board.Key() ^ (attacker ? BLUE_ATTACKER : 0) ^ (attacking ? 0 : DEFENDING);
+}
+
+template <size_t width, size_t height>
+const typename BasicProofSearch<width, height>::Entry* BasicProofSearch<width, height>::Probe(const uint64_t key) const {
+	const size_t first = key & (table.size() - 1) & ~(BUCKET_SIZE - 1);
+	for (size_t i = first; i < first + BUCKET_SIZE; ++i) {
+		if (table[i].key == key && table[i].work) {
+			return &table[i];
+		}
+	}
+	return nullptr;
+}
+
+template <size_t width, size_t height>
+void BasicProofSearch<width, height>::Store(const uint64_t key, const uint32_t proof, const uint32_t disproof,
+	const uint32_t work, const size_t ply) {
+	const size_t first = key & (table.size() - 1) & ~(BUCKET_SIZE - 1);
+
+	// The position's own entry, else an empty one, else the one with the least work
+	auto victim = table.begin() + first;
+	for (auto entry = victim; entry != table.begin() + first + BUCKET_SIZE; ++entry) {
+		if (entry->key == key) {
+			victim = entry;
+			break;
+		}
+		if (entry->work < victim->work) {
+			victim = entry;
+		}
+	}
+	if (victim->key != key && victim->work) {
+		++evictions;
+	}
+	*victim = { key, proof, disproof, std::max(work, 1u), static_cast<uint16_t>(std::min<size_t>(ply, UINT16_MAX)) };
+}
+
+template <size_t width, size_t height>
+std::pair<uint32_t, uint32_t> BasicProofSearch<width, height>::Numbers(const BoardType& board, const bool attacking) const {
+	if (attacker ? board.BlueWin() : board.RedWin()) return { 0, INFINITE_PROOF };
+	if (attacker ? board.RedWin() : board.BlueWin()) return { INFINITE_PROOF, 0 };
+	if (board.Drawn()) return { INFINITE_PROOF, 0 };
+	if (const auto entry = Probe(Key(board, attacker, attacking))) {
+		return { entry->proof, entry->disproof };
+	}
+	return { 1, 1 };
+}
+
+template <size_t width, size_t height>
+bool BasicProofSearch<width, height>::Stopped() {
+	if (!stopped) {
+		stopped = nodes >= nodeLimit ||
+			(nodes % CLOCK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline) ||
+			(cancel && cancel->load(std::memory_order_relaxed));
+	}
+	return stopped;
+}
+
+template <size_t width, size_t height>
+std::pair<uint32_t, uint32_t> BasicProofSearch<width, height>::Search(const BoardType& board, const bool attacking,
+	const uint32_t proofThreshold, const uint32_t disproofThreshold) {
+	const auto start = nodes++;
+
+	// The children's numbers are kept here while the position is searched, so that the search
+	// makes progress even if the table evicts them
+	std::vector<Child> children;
+	const bool blue = attacking == attacker;
+	for (const auto ply : board.CandidatePlies(blue)) {
+		const auto child = board.Play(ply, blue);
+		const auto [proof, disproof] = Numbers(child, !attacking);
+		children.push_back({ ply, child, proof, disproof });
+	}
+
+	// No plies left is a draw
+	uint32_t proof = INFINITE_PROOF, disproof = 0;
+	size_t best = 0;
+	while (!children.empty()) {
+		// The attacker needs one proven child, the defender one disproven child: the most proving child is
+		// the one with the least of those numbers, and the second least bounds how long it stays so
+		uint32_t sum = 0, least = INFINITE_PROOF, second = INFINITE_PROOF;
+		for (size_t i = 0; i < children.size(); ++i) {
+			const auto ours = attacking ? children[i].proof : children[i].disproof;
+			const auto theirs = attacking ? children[i].disproof : children[i].proof;
+			sum = std::min(INFINITE_PROOF, sum + theirs);
+			if (ours < least) {
+				second = least;
+				least = ours;
+				best = i;
+			}
+			else if (ours < second) {
+				second = ours;
+			}
+		}
+		proof = attacking ? least : sum;
+		disproof = attacking ? sum : least;
+		if (proof >= proofThreshold || disproof >= disproofThreshold || Stopped()) {
+			break;
+		}
+
+		// Search the child until it is no longer the most proving, or this position reaches a threshold
+		auto& child = children[best];
+		const auto bound = std::min(INFINITE_PROOF, second + 1);
+		std::tie(child.proof, child.disproof) = attacking ?
+			Search(child.board, false, std::min(proofThreshold, bound), disproofThreshold - disproof + child.disproof) :
+			Search(child.board, true, proofThreshold - proof + child.proof, std::min(disproofThreshold, bound));
+	}
+
+	Store(Key(board, attacker, attacking), proof, disproof,
+		static_cast<uint32_t>(std::min<uint64_t>(nodes - start, UINT32_MAX)),
+		children.empty() ? UINT16_MAX : children[best].ply);
+	return { proof, disproof };
+}
+
+template <size_t width, size_t height>
+uint64_t BasicProofSearch<width, height>::ProofSize(const BoardType& board, const bool attacking,
+	std::unordered_set<uint64_t>& visited) const {
+	const uint64_t key = Key(board, attacker, attacking);
+	if (!visited.insert(key).second) {
+		return 0;
+	}
+
+	// The game is over, or the table has evicted the position
+	const auto entry = Probe(key);
+	if (!entry || entry->proof != 0) {
+		return 1;
+	}
+
+	// The attacker's winning ply, or every defence
+	const bool blue = attacking == attacker;
+	uint64_t size = 1;
+	for (const auto ply : board.CandidatePlies(blue)) {
+		if (attacking && ply != entry->ply) continue;
+		size += ProofSize(board.Play(ply, blue), !attacking, visited);
+	}
+	return size;
+}
+
+template <size_t width, size_t height>
+ProofResult BasicProofSearch<width, height>::Run(const BoardType& board, const bool attacking, const ProofBudget budget,
+	const std::atomic<bool>* cancel) {
+	const auto begin = std::chrono::steady_clock::now();
+	nodes = 0;
+	evictions = 0;
+	nodeLimit = budget.nodes;
+	deadline = budget.time == std::chrono::milliseconds::max() ? std::chrono::steady_clock::time_point::max() : begin + budget.time;
+	this->cancel = cancel;
+	stopped = false;
+
+	ProofResult result{ ProofOutcome::UNKNOWN, {}, 0, 0, 0, 0.0 };
+	auto [proof, disproof] = Numbers(board, attacking);
+	if (proof && disproof) {
+		std::tie(proof, disproof) = Search(board, attacking, INFINITE_PROOF, INFINITE_PROOF);
+	}
+	if (proof == 0) {
+		std::unordered_set<uint64_t> visited;
+		result.outcome = ProofOutcome::PROVEN;
+		if (const auto entry = Probe(Key(board, attacker, attacking)); entry && attacking) {
+			result.ply = entry->ply;
+		}
+		result.proofSize = ProofSize(board, attacking, visited);
+	}
+	else if (disproof == 0) {
+		result.outcome = ProofOutcome::DISPROVEN;
+	}
+	result.nodes = nodes;
+	result.evictions = evictions;
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	return result;
+}
+
+template <size_t width, size_t height>
+ProofResult BasicProofSearch<width, height>::Solve(const BoardType& board, const bool blue, const ProofBudget budget,
+	const std::atomic<bool>* cancel) {
+	attacker = blue;
+	return Run(board, true, budget, cancel);
+}
+
+template <size_t width, size_t height>
+ProofResult BasicProofSearch<width, height>::SolveParallel(const BoardType& board, const bool blue,
+	const ProofBudget budget, const size_t threads) {
+	const auto begin = std::chrono::steady_clock::now();
+	const auto plies = board.CandidatePlies(blue);
+	const size_t workerCount = std::min(threads, plies.size());
+	if (workerCount <= 1 || board.RedWin() || board.BlueWin() || board.Drawn()) {
+		return BasicProofSearch().Solve(board, blue, budget);
+	}
+
+	// Each worker proves or disproves the positions after some of the root's plies, in which the opponent
+	// is to move. It searches them in rounds of growing budgets, so that a cheap proof isn't kept waiting
+	// behind a hard position, and keeps its table between rounds. The first proof cancels the rest
+	const size_t tableBits = Constants::PROOF_TABLE_BITS -
+		std::min<size_t>(std::bit_width(workerCount - 1), Constants::PROOF_TABLE_BITS - 4);
+	const uint64_t plyNodes = std::max<uint64_t>(budget.nodes / plies.size(), 1);
+	const auto deadline = budget.time == std::chrono::milliseconds::max() ?
+		std::chrono::steady_clock::time_point::max() : begin + budget.time;
+	std::vector<ProofResult> results(plies.size(), { ProofOutcome::UNKNOWN, {}, 0, 0, 0, 0.0 });
+	std::atomic<bool> proven{};
+	{
+		std::vector<std::jthread> workers;
+		for (size_t t = 0; t < workerCount; ++t) {
+			workers.emplace_back([&, t]() {
+				BasicProofSearch search(tableBits);
+				search.attacker = blue;
+				for (uint64_t round = FIRST_ROUND_NODES; !proven; round *= 4) {
+					bool open = false;
+					for (size_t i = t; i < plies.size() && !proven; i += workerCount) {
+						auto& result = results[i];
+						const auto now = std::chrono::steady_clock::now();
+						if (result.outcome != ProofOutcome::UNKNOWN || result.nodes >= plyNodes || now >= deadline) continue;
+
+						const ProofBudget roundBudget{ std::min(round, plyNodes - result.nodes), deadline == std::chrono::steady_clock::time_point::max() ?
+							std::chrono::milliseconds::max() : std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) };
+						const auto found = search.Run(board.Play(plies[i], blue), false, roundBudget, &proven);
+						result.outcome = found.outcome;
+						result.proofSize = found.proofSize;
+						result.nodes += found.nodes;
+						result.evictions += found.evictions;
+						if (found.outcome == ProofOutcome::PROVEN) {
+							proven = true;
+						}
+						open |= found.outcome == ProofOutcome::UNKNOWN;
+					}
+					if (!open) break;
+				}
+			});
+		}
+	}
+
+	// Proven by any ply, disproven by all of them
+	ProofResult result{ ProofOutcome::DISPROVEN, {}, 0, 0, 0, 0.0 };
+	for (size_t i = 0; i < plies.size(); ++i) {
+		result.nodes += results[i].nodes;
+		result.evictions += results[i].evictions;
+		if (results[i].outcome == ProofOutcome::PROVEN && !result.ply) {
+			result.outcome = ProofOutcome::PROVEN;
+			result.ply = plies[i];
+			result.proofSize = 1 + results[i].proofSize;
+		}
+		else if (results[i].outcome == ProofOutcome::UNKNOWN && result.outcome == ProofOutcome::DISPROVEN) {
+			result.outcome = ProofOutcome::UNKNOWN;
+		}
+	}
+	result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	return result;
+}
+
+template <size_t width, size_t height>
+void BasicProofSearch<width, height>::Clear() {
+	std::fill(table.begin(), table.end(), Entry{});
+}
+
+template class BasicProofSearch<15, 15>;
+template class BasicProofSearch<19, 19>;
+template class BasicProofSearch<7, 7>;
\ No newline at end of file
@@ -0,0 +1,129 @@
+// This header defines the proof-number solver, which proves or disproves that the color to move can force
+// five-in-a-row, instead of scoring positions to a fixed depth like Minimax. It is a depth-first proof-number
+// search (df-pn): every position has a proof number and a disproof number, the least number of positions
+// which must still be solved to prove or to disprove it, and the search always expands the most proving one.
+// Both sides play the plies of Board::CandidatePlies, so a proof holds against every defence the engine knows of.
+// A draw is a disproof.
+
+// The numbers are kept in a bounded table of buckets. When a bucket is full, the entry with the least work
+// (the fewest positions searched under it) is evicted, so memory never grows and the small subtrees,
+// which are the cheapest to search again, are collected first.
+
+// A search stops with an unknown result when its budget of positions or time runs out. SolveParallel searches
+// the replies to the root's plies on several threads, each with a table of its own, until one is proven.
+
+#pragma once
+
+#include "board.hpp"
+
+#include <vector>
+#include <unordered_set>
+#include <optional>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+
+enum class ProofOutcome { PROVEN, DISPROVEN, UNKNOWN };
+
+// The most a search may do before giving up
+struct ProofBudget {
+	uint64_t nodes = std::numeric_limits<uint64_t>::max();
+	std::chrono::milliseconds time = std::chrono::milliseconds::max();
+};
+
+struct ProofResult {
+	ProofOutcome outcome;
+	// The winning ply, if proven
+	std::optional<size_t> ply;
+	// The positions expanded
+	uint64_t nodes;
+	// The positions of the proof (the winning plies, and every reply to them), if proven.
+	// Parts of the proof the table has evicted aren't counted
+	uint64_t proofSize;
+	// The entries the table evicted
+	uint64_t evictions;
+	double milliseconds;
+};
+
+template <size_t width, size_t height>
+class BasicProofSearch {
+public:
+	using BoardType = BasicBoard<width, height>;
+
+	// A search with a table of 2^tableBits entries
+	explicit BasicProofSearch(const size_t tableBits = Constants::PROOF_TABLE_BITS);
+
+	// Tries to prove that the color to move wins the board. Stops early if cancel is set
+	ProofResult Solve(const BoardType& board, const bool blue, const ProofBudget budget,
+		const std::atomic<bool>* cancel = nullptr);
+
+	// Solves the board on threads threads, splitting the root's plies between them (and the budget's nodes
+	// between the plies). The table bits are split between the threads too
+	static ProofResult SolveParallel(const BoardType& board, const bool blue, const ProofBudget budget,
+		const size_t threads);
+
+	// Empties the table
+	void Clear();
+
+private:
+	// Proof and disproof numbers saturate at INFINITE_PROOF, which means proven or disproven
+	static constexpr uint32_t INFINITE_PROOF = 1u << 30;
+
+	// The number of entries which may hold a position
+	static constexpr size_t BUCKET_SIZE = 4;
+
+	struct Entry {
+		uint64_t key;
+		uint32_t proof;
+		uint32_t disproof;
+		// The positions searched under this one, the last time it was
+		uint32_t work;
+		// The most proving ply, which for a proven position to move for the attacker is the winning one
+		uint16_t ply;
+	};
+
+	struct Child {
+		size_t ply;
+		BoardType board;
+		uint32_t proof;
+		uint32_t disproof;
+	};
+
+	// The key of a position, with the attacker and whether it is to move
+	static uint64_t Key(const BoardType& board, const bool attacker, const bool attacking);
+
+	const Entry* Probe(const uint64_t key) const;
+	void Store(const uint64_t key, const uint32_t proof, const uint32_t disproof, const uint32_t work,
+		const size_t ply);
+
+	// Returns the proof and disproof numbers of a position, from the board if the game is over, else the table
+	std::pair<uint32_t, uint32_t> Numbers(const BoardType& board, const bool attacking) const;
+
+	// Searches the position until its numbers reach either threshold, or the budget runs out,
+	// and returns them
+	std::pair<uint32_t, uint32_t> Search(const BoardType& board, const bool attacking, const uint32_t proofThreshold,
+		const uint32_t disproofThreshold);
+
+	// Solves the position, which is the attacker's to move if attacking
+	ProofResult Run(const BoardType& board, const bool attacking, const ProofBudget budget,
+		const std::atomic<bool>* cancel);
+
+	// Whether the budget has run out (or the search was cancelled)
+	bool Stopped();
+
+	// Counts the positions of the proof of the position, visiting each once
+	uint64_t ProofSize(const BoardType& board, const bool attacking, std::unordered_set<uint64_t>& visited) const;
+
+	std::vector<Entry> table;
+	bool attacker{};
+	uint64_t nodes{};
+	uint64_t evictions{};
+	uint64_t nodeLimit{};
+	std::chrono::steady_clock::time_point deadline{};
+	const std::atomic<bool>* cancel{};
+	bool stopped{};
+};
+
+// The solver of the configured board
+using ProofSearch = BasicProofSearch<Constants::BOARD_WIDTH, Constants::BOARD_HEIGHT>;
\ No newline at end of file
@@ -1,8 +0,0 @@
-#version 330 core
-
-uniform vec4 colorUniform;
-out vec4 fragColor;
-
-void main() {
-	fragColor = colorUniform;
-}
\ No newline at end of file
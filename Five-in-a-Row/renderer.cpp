@@ -3,12 +3,15 @@
 #include "constants.hpp"
 #include "board.hpp"
 #include "window.hpp"
+#include "shaderSources.hpp"
 
 #include "glm/glm.hpp"
 
 #include <utility>
 #include <stdexcept>
 #include <format>
+#include <cstddef>
+#include <algorithm>
 
 using namespace Constants;
 
@@ -20,8 +23,8 @@ Renderer::Renderer() {
 
 	glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
 
-	rectShader = ShaderProgram("rectVertexShader.glsl", "rectFragmentShader.glsl");
-	circleShader = ShaderProgram("circleVertexShader.glsl", "circleFragmentShader.glsl");
+	boardShader = ShaderProgram({ ShaderSources::BOARD_VERTEX, "boardVertexShader.glsl" },
+		{ ShaderSources::BOARD_FRAGMENT, "boardFragmentShader.glsl" }, SHADER_CACHE_PATH);
 
 	glGenVertexArrays(1, &normalSquareVAO);
 	glBindVertexArray(normalSquareVAO);
@@ -32,6 +35,20 @@ Renderer::Renderer() {
 	glBufferData(GL_ARRAY_BUFFER, sizeof(NORMAL_SQUARE_VERTEX_BUFFER), NORMAL_SQUARE_VERTEX_BUFFER, GL_STATIC_DRAW);
 	glVertexAttribPointer(0, 2, GL_FLOAT, false, 2 * sizeof(float), reinterpret_cast<void*>(0));
 
+	// The instance attributes advance once per instance, instead of per vertex
+	glGenBuffers(1, &instanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, BOARD_SIZE * CELL_INSTANCES * sizeof(Instance), nullptr, GL_DYNAMIC_DRAW);
+	const auto attribute = [](const GLuint index, const GLint size, const size_t offset) {
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index, size, GL_FLOAT, false, sizeof(Instance), reinterpret_cast<void*>(offset));
+		glVertexAttribDivisor(index, 1);
+	};
+	attribute(1, 2, offsetof(Instance, offset));
+	attribute(2, 2, offsetof(Instance, scale));
+	attribute(3, 4, offsetof(Instance, color));
+	attribute(4, 1, offsetof(Instance, circle));
+
 	// We'll leave the objects bound for the entirety of the application, since they're the only ones we'll use
 
 	// We need alpha blending for the circle drawing
@@ -41,95 +58,118 @@ Renderer::Renderer() {
 
 Renderer::~Renderer() noexcept {
 	// If this is moved from, OpenGL will simply ignore these
+	glDeleteBuffers(1, &instanceVBO);
 	glDeleteBuffers(1, &normalSquareVBO);
 	glDeleteVertexArrays(1, &normalSquareVAO);
 }
 
-void Renderer::Draw(Window& window, const Board& board, const bool drawSelected,
+std::array<Renderer::Instance, Renderer::CELL_INSTANCES> Renderer::CellInstances(const size_t i, const size_t j,
+	const CellState state, const bool lastPly, const bool ghost) {
+
+	// First we setup the transform for the cell
+	const std::array<float, 2> offset{
+		-1.0f + // left edge
+		1.0f / static_cast<float>(BOARD_WIDTH) + // initial offset
+		static_cast<float>(i) * 2.0f / static_cast<float>(BOARD_WIDTH), // additional offset per i
+
+		1.0f - // top edge
+		1.0f / static_cast<float>(BOARD_HEIGHT) - // initial offset
+		static_cast<float>(j) * 2.0f / static_cast<float>(BOARD_HEIGHT) // additional offset per j
+	};
+	const std::array<float, 2> scale{ static_cast<float>(CELL_WIDTH_FACTOR) / static_cast<float>(BOARD_WIDTH),
+		static_cast<float>(CELL_WIDTH_FACTOR) / static_cast<float>(BOARD_HEIGHT) };
+	const std::array<float, 2> outerScale{ scale[0] * PIECE_WIDTH_FACTOR, scale[1] * PIECE_WIDTH_FACTOR };
+	const std::array<float, 2> innerScale{ outerScale[0] * PIECE_INNER_FACTOR, outerScale[1] * PIECE_INNER_FACTOR };
+
+	// Determine the color to draw the cell
+	const auto rectColor = lastPly ? std::array{ 0.8f, 0.8f, 0.8f, 1.0f } : std::array{ 1.0f, 1.0f, 1.0f, 1.0f };
+	std::array<Instance, CELL_INSTANCES> cell{
+		Instance{ offset, scale, rectColor, 0.0f },
+		// No piece: the circles are empty
+		Instance{ offset, {}, {}, 1.0f },
+		Instance{ offset, {}, {}, 1.0f }
+	};
+
+	// Do we draw a piece?
+	if (state != CellState::EMPTY) {
+		// "Outer" circle, then "inner" circle
+		cell[1] = { offset, outerScale, state == CellState::BLUE ? std::array{ 0.0f, 0.0f, OUTER_COLOR_FACTOR, 1.0f } :
+			std::array{ OUTER_COLOR_FACTOR, 0.0f, 0.0f, 1.0f }, 1.0f };
+		cell[2] = { offset, innerScale, state == CellState::BLUE ? std::array{ 0.0f, 0.0f, 1.0f, 1.0f } :
+			std::array{ 1.0f, 0.0f, 0.0f, 1.0f }, 1.0f };
+	}
+	// Do we draw a ghost piece?
+	else if (ghost) {
+		cell[1] = { offset, outerScale, { 0.5f, 0.5f, OUTER_COLOR_FACTOR, 1.0f }, 1.0f };
+		cell[2] = { offset, innerScale, { 0.5f, 0.5f, 1.0f, 1.0f }, 1.0f };
+	}
+	return cell;
+}
+
+FrameStatistics Renderer::Draw(Window& window, const Board& board, const bool drawSelected,
 	const std::optional<size_t> lastPly) {
 	
 	// Clear the buffer
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
 
-	auto selected = board.Selected(window.CursorPosition());
-
-	// Iterate through the cells of the board and draw each one
+	const auto selected = drawSelected ? board.Selected(window.CursorPosition()) : std::nullopt;
+
+	// Iterate through the cells of the board, and write the runs of changed ones to the instance buffer
+	const bool first = instances.empty();
+	instances.resize(BOARD_SIZE * CELL_INSTANCES);
+	size_t updated = 0;
+	std::optional<size_t> run;
+	const auto write = [&](const size_t end) {
+		glBufferSubData(GL_ARRAY_BUFFER, *run * sizeof(Instance), (end - *run) * sizeof(Instance), &instances[*run]);
+		updated += end - *run;
+		run.reset();
+	};
 	for (size_t j = 0; j < BOARD_HEIGHT; ++j) {
 		for (size_t i = 0; i < BOARD_WIDTH; ++i) {
-
-			// First we setup the transform for the cell
-			glm::mat3 transform(0.0f);
-			transform[0][0] = static_cast<float>(CELL_WIDTH_FACTOR) / static_cast<float>(BOARD_WIDTH);
-			transform[1][1] = static_cast<float>(CELL_WIDTH_FACTOR) / static_cast<float>(BOARD_HEIGHT);
-			transform[2][2] = 1.0f;
-
-			transform[2][0] = -1.0f + // left edge
-				1.0f / static_cast<float>(BOARD_WIDTH) + // initial offset
-				static_cast<float>(i) * 2.0f / static_cast<float>(BOARD_WIDTH); // additional offset per i
-
-			transform[2][1] = 1.0f - // top edge
-				1.0f / static_cast<float>(BOARD_HEIGHT) - // initial offset
-				static_cast<float>(j) * 2.0f / static_cast<float>(BOARD_HEIGHT); // additional offset per j
-
-			// Determine the color to draw the cell
-			const auto rectColor = (lastPly && *lastPly % BOARD_WIDTH == i
-				&& *lastPly / BOARD_WIDTH == j) ?
-				glm::vec4(0.8f, 0.8f, 0.8f, 1.0f) : glm::vec4(1.0f);
-
-			// Render it
-			rectShader.Run(transform, rectColor);
-
-			// Do we draw a piece?
-			if (auto state = board.At(i, j); state != CellState::EMPTY) {
-
-				// "Outer" circle
-				transform[0][0] *= PIECE_WIDTH_FACTOR;
-				transform[1][1] *= PIECE_WIDTH_FACTOR;
-				const auto innerColor = state == CellState::BLUE ? glm::vec4(0.0f, 0.0f, OUTER_COLOR_FACTOR, 1.0f)
-					: glm::vec4(OUTER_COLOR_FACTOR, 0.0f, 0.0f, 1.0f);
-				circleShader.Run(transform, innerColor);
-
-				// "Inner" circle
-				transform[0][0] *= PIECE_INNER_FACTOR;
-				transform[1][1] *= PIECE_INNER_FACTOR;
-				const auto outerColor = state == CellState::BLUE ? glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)
-					: glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
-				circleShader.Run(transform, outerColor);
-
+			const size_t pos = j * BOARD_WIDTH + i;
+			const auto cell = CellInstances(i, j, board.At(i, j), lastPly == pos, selected == pos);
+			const auto index = pos * CELL_INSTANCES;
+			if (first || !std::equal(cell.begin(), cell.end(), instances.begin() + index)) {
+				std::copy(cell.begin(), cell.end(), instances.begin() + index);
+				if (!run) {
+					run = index;
+				}
+			}
+			else if (run) {
+				write(index);
 			}
-			// Do we draw a ghost piece?
-			else if (drawSelected && selected && *selected % BOARD_WIDTH == i &&
-				*selected / BOARD_WIDTH == j) {
-
-				// "Outer" circle
-				transform[0][0] *= PIECE_WIDTH_FACTOR;
-				transform[1][1] *= PIECE_WIDTH_FACTOR;
-				const auto outerColor = glm::vec4(0.5f, 0.5f, OUTER_COLOR_FACTOR, 1.0f);
-				circleShader.Run(transform, outerColor);
-
-				// "Inner" circle
-				transform[0][0] *= PIECE_INNER_FACTOR;
-				transform[1][1] *= PIECE_INNER_FACTOR;
-				const auto innerColor = glm::vec4(0.5f, 0.5f, 1.0f, 1.0f);
-				circleShader.Run(transform, innerColor);
-			};
 		}
 	}
+	if (run) {
+		write(instances.size());
+	}
+
+	// Render them all at once
+	const auto drawCalls = boardShader.DrawCalls();
+	boardShader.RunInstanced(instances.size());
+
 	// Swap the buffers
 	window.DrawFrame();
+	return { boardShader.DrawCalls() - drawCalls, updated };
 }
 
 Renderer::Renderer(Renderer&& other) noexcept :
-	rectShader(std::move(other.rectShader)),
-	circleShader(std::move(other.circleShader)),
+	boardShader(std::move(other.boardShader)),
 	normalSquareVAO(std::exchange(other.normalSquareVAO, 0)),
-	normalSquareVBO(std::exchange(other.normalSquareVBO, 0)) {}
+	normalSquareVBO(std::exchange(other.normalSquareVBO, 0)),
+	instanceVBO(std::exchange(other.instanceVBO, 0)),
+	instances(std::move(other.instances)) {}
 
 Renderer& Renderer::operator=(Renderer&& other) noexcept {
-	rectShader = std::move(other.rectShader);
-	circleShader = std::move(other.circleShader);
+	boardShader = std::move(other.boardShader);
 	normalSquareVAO = std::exchange(other.normalSquareVAO, 0);
 	normalSquareVBO = std::exchange(other.normalSquareVBO, 0);
+	instanceVBO = std::exchange(other.instanceVBO, 0);
+	instances = std::move(other.instances);
 	return *this;
+}
+
+bool Renderer::ShaderCached() const {
+	return boardShader.Cached();
 }
\ No newline at end of file
@@ -1,11 +1,26 @@
 // This header defines the Renderer class, which renders a board to a window
+// The whole board is a single instanced draw call: every cell is three instances of the unit square (the cell,
+// and the outer and inner circles of its piece, empty if it has none), whose offsets, sizes, colors and shapes
+// are per-instance attributes. The instance buffer is kept between frames, and only the cells which changed
+// are written to it
 
 #pragma once
 
 #include "shader.hpp"
+#include "board.hpp"
+
+#include <vector>
+#include <array>
+#include <optional>
 
 class Window;
-class Board;
+
+// What drawing a frame took
+struct FrameStatistics {
+	size_t drawCalls;
+	// The instances written to the instance buffer
+	size_t updatedInstances;
+};
 
 class Renderer {
 
@@ -16,9 +31,12 @@ public:
 	// Draws the board to the window argument. If drawSelected, a ghost piece is drawn
 	// at cursor's selected cell, if existent. If lastPly has a value, the cell is darkened slightly,
 	// (indicating this cell was the one that was just played on)
-	void Draw(Window& window, const Board& board, const bool drawSelected, 
+	FrameStatistics Draw(Window& window, const Board& board, const bool drawSelected, 
 		const std::optional<size_t> lastPly);
 
+	// Whether the shader program was loaded from its binary cache (see ShaderProgram) instead of compiled
+	bool ShaderCached() const;
+
 	// Renderer move is not trivial, it manages resources
 	Renderer(Renderer&& other) noexcept;
 	Renderer& operator=(Renderer&& other) noexcept;
@@ -27,9 +45,27 @@ public:
 	Renderer(const Renderer&) = delete;
 	Renderer& operator=(const Renderer&) = delete;
 private:
+	// The per-instance attributes, in the layout of the instance buffer
+	struct Instance {
+		std::array<float, 2> offset;
+		std::array<float, 2> scale;
+		std::array<float, 4> color;
+		// 1 for a circle, 0 for a square
+		float circle;
 
-	ShaderProgram rectShader;
-	ShaderProgram circleShader;
+		bool operator==(const Instance&) const = default;
+	};
+	static constexpr size_t CELL_INSTANCES = 3;
+
+	// Returns the instances of the cell at (i, j)
+	static std::array<Instance, CELL_INSTANCES> CellInstances(const size_t i, const size_t j, const CellState state,
+		const bool lastPly, const bool ghost);
+
+	ShaderProgram boardShader;
 	unsigned int normalSquareVAO;
 	unsigned int normalSquareVBO;
+	unsigned int instanceVBO;
+
+	// The instances in the instance buffer, empty until the first frame
+	std::vector<Instance> instances;
 };
\ No newline at end of file
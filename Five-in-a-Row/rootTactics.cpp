@@ -0,0 +1,32 @@
+#include "rootTactics.hpp"
+
+template <size_t width, size_t height>
+std::optional<TacticalPly> ForcedPly(const BasicBoard<width, height>& board, const bool blue) {
+	if (board.RedWin() || board.BlueWin()) {
+		return std::nullopt;
+	}
+
+	// The threats are the color's wins if it has any, else the blocks of the opponent's fours
+	const auto threats = board.ThreatPlies(blue);
+	if (!threats.empty() && board.WinsAt(threats.front(), blue)) {
+		return TacticalPly{ threats.front(), Tactic::WIN };
+	}
+	if (!threats.empty() && board.WinsAt(threats.front(), !blue)) {
+		if (threats.size() == 1) {
+			return TacticalPly{ threats.front(), Tactic::BLOCK };
+		}
+		return std::nullopt;
+	}
+
+	// Two threats at once, the first found. Their cells may be out of range, so every empty cell is tried
+	for (size_t pos = 0; pos < board.SIZE; ++pos) {
+		if (board.At(pos) == CellState::EMPTY && board.ThreatsAt(pos, blue) >= 2) {
+			return TacticalPly{ pos, Tactic::DOUBLE_THREAT };
+		}
+	}
+	return std::nullopt;
+}
+
+template std::optional<TacticalPly> ForcedPly<15, 15>(const BasicBoard<15, 15>&, const bool);
+template std::optional<TacticalPly> ForcedPly<19, 19>(const BasicBoard<19, 19>&, const bool);
+template std::optional<TacticalPly> ForcedPly<7, 7>(const BasicBoard<7, 7>&, const bool);
\ No newline at end of file
@@ -0,0 +1,23 @@
+// This header defines the root tactics: the plies which the position forces, so that a decision needs no search.
+// They are checked in order of urgency, through the "fives" around the candidate cells only (see Board::WinsAt
+// and Board::ThreatsAt): a ply which wins at once, the one ply which blocks the opponent's four, and, when the
+// opponent has no four, a ply which makes two threats at once (an open four or a double four), which wins in three.
+// Anything else, including two fours of the opponent's (which no ply blocks), is left to the search
+
+#pragma once
+
+#include "board.hpp"
+
+#include <optional>
+#include <cstdint>
+
+enum class Tactic : uint8_t { NONE, WIN, BLOCK, DOUBLE_THREAT };
+
+struct TacticalPly {
+	size_t ply;
+	Tactic tactic;
+};
+
+// Returns the ply forced for the color to move on the board (of any instantiated size), if any
+template <size_t width, size_t height>
+std::optional<TacticalPly> ForcedPly(const BasicBoard<width, height>& board, const bool blue);
\ No newline at end of file
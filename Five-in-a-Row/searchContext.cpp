@@ -0,0 +1,103 @@
+#include "searchContext.hpp"
+
+#include <algorithm>
+
+// Mixed into the keys of positions in which blue (the minimizer) is to move
+constexpr uint64_t MIN_TO_MOVE = 0xC2B2AE3D27D4EB4Full;
+
+SearchContext::SearchContext() : table(TABLE_SIZE) {}
+
+uint64_t SearchContext::Key(const uint64_t key, const bool max) {
+	return key ^ (max ? 0 : MIN_TO_MOVE);
+}
+
+const TranspositionEntry* SearchContext::Probe(const uint64_t key, const bool max) {
+	++statistics.probes;
+	const auto mixed = Key(key, max);
+	const auto& entry = table[mixed & (TABLE_SIZE - 1)];
+	if (entry.key != mixed) {
+		return nullptr;
+	}
+	++statistics.hits;
+	return &entry;
+}
+
+void SearchContext::Store(const uint64_t key, const bool max, const size_t depth, const Score score,
+	const size_t ply, const Bound bound) {
+	const auto mixed = Key(key, max);
+	auto& entry = table[mixed & (TABLE_SIZE - 1)];
+	if (entry.depth > depth && (entry.key == mixed || !depth)) {
+		return;
+	}
+	entry = { mixed, score, static_cast<uint16_t>(std::min<size_t>(ply, TranspositionEntry::NO_PLY)),
+		static_cast<uint8_t>(depth), bound };
+}
+
+void SearchContext::CountCutoff() {
+	++statistics.cutoffs;
+}
+
+void SearchContext::RecordCutoff(const size_t ply, const size_t depth) {
+	if (ply >= history.size()) {
+		history.resize(ply + 1);
+	}
+	history[ply] += static_cast<uint32_t>(depth * depth);
+}
+
+void SearchContext::OrderByHistory(std::vector<size_t>& plies) const {
+	auto score = [&](const size_t ply) { return ply < history.size() ? history[ply] : 0u; };
+	std::stable_sort(plies.begin(), plies.end(), [&](const size_t lhs, const size_t rhs) {
+		return score(lhs) > score(rhs);
+	});
+}
+
+void SearchContext::Promote(std::vector<size_t>& plies, const uint16_t ply) {
+	if (const auto it = std::find(plies.begin(), plies.end(), ply); it != plies.end()) {
+		std::rotate(plies.begin(), it, it + 1);
+	}
+}
+
+void SearchContext::ClearVariation(const size_t depth) {
+	variationLengths[depth] = 0;
+}
+
+void SearchContext::UpdateVariation(const size_t depth, const size_t ply) {
+	// A child on the horizon has no line of its own
+	const size_t length = depth > 1 ? variationLengths[depth - 1] : 0;
+	variations[depth][0] = static_cast<uint16_t>(ply);
+	std::copy_n(variations[depth - 1].begin(), length, variations[depth].begin() + 1);
+	variationLengths[depth] = static_cast<uint8_t>(length + 1);
+}
+
+std::vector<size_t> SearchContext::Variation(const size_t depth) const {
+	return { variations[depth].begin(), variations[depth].begin() + variationLengths[depth] };
+}
+
+void SearchContext::Clear() {
+	std::fill(table.begin(), table.end(), TranspositionEntry{});
+	history.clear();
+	variationLengths = {};
+	statistics = {};
+	SetDeadline(std::chrono::steady_clock::time_point::max());
+}
+
+void SearchContext::SetDeadline(const std::chrono::steady_clock::time_point deadline) {
+	this->deadline = deadline;
+	nodes = 0;
+	expired = false;
+}
+
+bool SearchContext::CheckDeadline() {
+	if (!expired && deadline != std::chrono::steady_clock::time_point::max() && ++nodes % DEADLINE_INTERVAL == 0) {
+		expired = std::chrono::steady_clock::now() >= deadline;
+	}
+	return expired;
+}
+
+bool SearchContext::Expired() const {
+	return expired;
+}
+
+const SearchStatistics& SearchContext::Statistics() const {
+	return statistics;
+}
\ No newline at end of file
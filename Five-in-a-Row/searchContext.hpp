@@ -0,0 +1,117 @@
+// This header defines the search context: the state which Minimax can keep between searches.
+// It is a transposition table of scores, bounds and best plies keyed by position (see Board::Key),
+// and history counters of the plies which caused cutoffs, which order the children of unsorted depths.
+// Passed to consecutive searches within a game, the search of a position reuses what the searches of its
+// ancestors learned about it and its subtrees. It only stays valid for one goal function.
+// It also collects the principal variation of the search in a triangular array: the node with depth plies
+// left keeps its line in row depth, made of its best ply and the row depth - 1 its child left behind.
+// It may carry a deadline, which stops the search in the middle of its tree (see SetDeadline).
+// It is not threadsafe: every concurrent search needs a context of its own (or none)
+
+#pragma once
+
+#include "constants.hpp"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <chrono>
+
+// What a transposition table score says about the true value of a position
+enum class Bound : uint8_t { EXACT, LOWER, UPPER };
+
+struct TranspositionEntry {
+	uint64_t key{};
+	Score score{};
+	// The best ply found, or NO_PLY
+	uint16_t ply{ NO_PLY };
+	// The depth the position was searched to
+	uint8_t depth{};
+	Bound bound{};
+
+	static constexpr uint16_t NO_PLY = UINT16_MAX;
+};
+
+// The counters of SearchContext
+struct SearchStatistics {
+	// Transposition table lookups, and how many found their position
+	uint64_t probes;
+	uint64_t hits;
+	// Searches of a position answered by the table alone
+	uint64_t cutoffs;
+};
+
+class SearchContext {
+public:
+	// The number of table entries, and the bytes they take up
+	static constexpr size_t TABLE_SIZE = size_t{ 1 } << Constants::TRANSPOSITION_TABLE_BITS;
+	static constexpr size_t FOOTPRINT = TABLE_SIZE * sizeof(TranspositionEntry);
+
+	// The deepest search which collects its principal variation
+	static constexpr size_t MAX_DEPTH = 32;
+
+	// How many nodes are searched between looks at the clock
+	static constexpr uint64_t DEADLINE_INTERVAL = 256;
+
+	SearchContext();
+
+	// Returns the entry of the position, if the table has one
+	const TranspositionEntry* Probe(const uint64_t key, const bool max);
+
+	// Stores the result of a search of the position. It replaces any other position in its slot,
+	// but only a shallower search of the same position. A result of depth 0 (a hint of the best ply, which never
+	// cuts off a search) replaces no deeper entry at all
+	void Store(const uint64_t key, const bool max, const size_t depth, const Score score,
+		const size_t ply, const Bound bound);
+
+	// Counts a search of a position answered by the table alone
+	void CountCutoff();
+
+	// Records that the ply caused a cutoff at the depth
+	void RecordCutoff(const size_t ply, const size_t depth);
+
+	// Sorts the plies by their history, those that caused the most (and deepest) cutoffs first
+	void OrderByHistory(std::vector<size_t>& plies) const;
+
+	// Moves the ply to the front of the plies, if it is among them
+	static void Promote(std::vector<size_t>& plies, const uint16_t ply);
+
+	// Empties the line of the node with depth plies left
+	void ClearVariation(const size_t depth);
+
+	// Makes the ply, followed by the line of its child, the line of the node with depth plies left
+	void UpdateVariation(const size_t depth, const size_t ply);
+
+	// Returns the line of the last node searched with depth plies left
+	std::vector<size_t> Variation(const size_t depth) const;
+
+	// Sets the time after which the search stops, and clears Expired. The search then unwinds at once, scoring
+	// nothing and storing nothing, and the root answers the best of its children so far. time_point::max() never expires
+	void SetDeadline(const std::chrono::steady_clock::time_point deadline);
+
+	// Counts a node searched, and returns whether the deadline has passed (looking at the clock every
+	// DEADLINE_INTERVAL nodes)
+	bool CheckDeadline();
+
+	// Returns whether the deadline had passed when it was last checked
+	bool Expired() const;
+
+	// Empties the table and the history, resets the counters, and removes the deadline
+	void Clear();
+
+	// Returns the counters since the last Clear
+	const SearchStatistics& Statistics() const;
+
+private:
+	// The key of the position with the color to move, which Minimax knows by max
+	static uint64_t Key(const uint64_t key, const bool max);
+
+	std::vector<TranspositionEntry> table;
+	std::vector<uint32_t> history;
+	std::array<std::array<uint16_t, MAX_DEPTH>, MAX_DEPTH> variations{};
+	std::array<uint8_t, MAX_DEPTH> variationLengths{};
+	SearchStatistics statistics{};
+	std::chrono::steady_clock::time_point deadline{ std::chrono::steady_clock::time_point::max() };
+	uint64_t nodes{};
+	bool expired{};
+};
\ No newline at end of file
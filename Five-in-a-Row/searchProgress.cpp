@@ -0,0 +1,34 @@
+#include "searchProgress.hpp"
+
+void SearchProgress::Publish(const Progress& progress) {
+	// Odd while the fields are written, which no reader takes
+	const auto begun = sequence.load(std::memory_order_relaxed) + 1;
+	sequence.store(begun, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	ply.store(progress.ply, std::memory_order_relaxed);
+	score.store(progress.score, std::memory_order_relaxed);
+	depth.store(progress.depth, std::memory_order_relaxed);
+	searched.store(progress.searched, std::memory_order_relaxed);
+	total.store(progress.total, std::memory_order_relaxed);
+
+	sequence.store(begun + 1, std::memory_order_release);
+}
+
+Progress SearchProgress::Read() const {
+	while (true) {
+		const auto before = sequence.load(std::memory_order_acquire);
+		if (before % 2) {
+			continue;
+		}
+
+		const Progress progress{ ply.load(std::memory_order_relaxed), score.load(std::memory_order_relaxed),
+			depth.load(std::memory_order_relaxed), searched.load(std::memory_order_relaxed),
+			total.load(std::memory_order_relaxed), before / 2 };
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence.load(std::memory_order_relaxed) == before) {
+			return progress;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+// This header defines the search progress, a snapshot of how far a running search has got, which the search
+// publishes as it improves and any thread may read without waiting for the search to finish (e.g. to show it,
+// or to play the best ply so far when out of time).
+// It is a sequence lock: the one publishing thread makes the sequence odd while it writes, and a reader
+// retries until it has read the fields between two equal, even sequences. Neither side ever blocks or allocates
+
+#pragma once
+
+#include "constants.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+struct Progress {
+	// The best root ply so far, and its score
+	size_t ply;
+	Score score;
+	// The depth of the search
+	size_t depth;
+	// The work done, and the work there is: the root plies searched of all of them, or the playouts of
+	// a Monte Carlo search (of which there is no telling how many there are)
+	uint64_t searched;
+	uint64_t total;
+	// The times the progress has been published, 0 before the search has begun
+	uint64_t updates;
+};
+
+class SearchProgress {
+public:
+	// Publishes the progress (whose updates are ignored, and counted instead). Only one thread may publish
+	void Publish(const Progress& progress);
+
+	// Returns the progress last published
+	Progress Read() const;
+
+private:
+	std::atomic<uint64_t> sequence{};
+	std::atomic<size_t> ply{};
+	std::atomic<Score> score{};
+	std::atomic<size_t> depth{};
+	std::atomic<uint64_t> searched{};
+	std::atomic<uint64_t> total{};
+};
\ No newline at end of file
@@ -1,10 +1,15 @@
 #include "shader.hpp"
 #include "reflections.hpp"
 
-#include "glm/gtc/type_ptr.hpp"
+#include "constants.hpp"
 
 #include <fstream>
 #include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+#include <cstdint>
 
 // A utility for loading the file at path into the returned string
 std::string ReadFile(const std::filesystem::path path) {
@@ -17,15 +22,58 @@ std::string ReadFile(const std::filesystem::path path) {
 	return stream.str();
 }
 
+// Returns the source of the shader, from its file with Constants::SHADER_FILES
+std::string LoadSource(const ShaderSource& shader) {
+	return Constants::SHADER_FILES ? ReadFile(shader.path) : shader.source;
+}
+
+// The program binary functions are only core since OpenGL 4.1 (and ARB_get_program_binary before),
+// so they are looked up at runtime, where the driver has them
+namespace ProgramBinary {
+	constexpr GLenum RETRIEVABLE_HINT = 0x8257;
+	constexpr GLenum LENGTH = 0x8741;
+	constexpr GLenum FORMAT_COUNT = 0x87FE;
+
+	using GetFunction = void (APIENTRYP)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+	using LoadFunction = void (APIENTRYP)(GLuint, GLenum, const void*, GLsizei);
+	using ParameterFunction = void (APIENTRYP)(GLuint, GLenum, GLint);
+
+	// The cache file: the header, then the binary
+	struct Header {
+		uint64_t magic;
+		uint64_t key;
+		GLenum format;
+		uint32_t length;
+	};
+	constexpr uint64_t MAGIC = 0x4E49425241484653; // "SHFARBIN"
+
+	// Returns the key of the sources on this driver, a 64-bit FNV-1a hash
+	uint64_t Key(const std::initializer_list<std::string_view> parts) {
+		uint64_t hash = 0xCBF29CE484222325;
+		for (const auto part : parts) {
+			for (const auto byte : part) {
+				hash = (hash ^ static_cast<uint8_t>(byte)) * 0x100000001B3;
+			}
+			hash = (hash ^ 0xFF) * 0x100000001B3;
+		}
+		return hash;
+	}
+
+	// Returns the driver's string, or an empty one
+	std::string_view DriverString(const GLenum name) {
+		const auto string = glGetString(name);
+		return string ? reinterpret_cast<const char*>(string) : "";
+	}
+}
+
 // A shader class to simplify the code, which is hidden from the user of ShaderProgram
 class Shader {
 public:
-	Shader(const GLenum type, const std::filesystem::path path) {
+	Shader(const GLenum type, const std::string& sourceString, const std::filesystem::path& path) {
 		id = glCreateShader(type);
 		if (!id) {
 			throw std::runtime_error(std::format("Could not create shader: {}.", ReflectGLerror(glGetError())));
 		}
-		const auto sourceString = ReadFile(path);
 		const auto ptr = sourceString.c_str();
 
 		glShaderSource(id, 1, &ptr, nullptr);
@@ -65,40 +113,87 @@ private:
 	GLuint id;
 };
 
-ShaderProgram::ShaderProgram() noexcept : id{}, transformUniform{}, colorUniform{} {}
-
-ShaderProgram::ShaderProgram(std::filesystem::path vertexShaderPath, std::filesystem::path fragmentShaderPath) {
-	Shader vertexShader(GL_VERTEX_SHADER, vertexShaderPath);
-	Shader fragmentShader(GL_FRAGMENT_SHADER, fragmentShaderPath);
-	//const auto fragmentShaderSource = ReadFile(vertexShaderPath);
+ShaderProgram::ShaderProgram() noexcept : id{} {}
 
+ShaderProgram::ShaderProgram(const ShaderSource& vertexShaderSource, const ShaderSource& fragmentShaderSource,
+	const std::filesystem::path& cachePath) {
+	const auto vertexSource = LoadSource(vertexShaderSource);
+	const auto fragmentSource = LoadSource(fragmentShaderSource);
 	id = glCreateProgram();
-	glAttachShader(id, vertexShader.getID());
-	glAttachShader(id, fragmentShader.getID());
-	glLinkProgram(id);
-
-	int success;
-	glGetProgramiv(id, GL_LINK_STATUS, &success);
-	if (!success) {
-		char infoLog[512];
-		glGetProgramInfoLog(id, 512, nullptr, infoLog);
-		throw std::runtime_error(std::format("Could not link shader: {}", infoLog));
+
+	// Can the driver cache the program?
+	GLint formats = 0;
+	glGetIntegerv(ProgramBinary::FORMAT_COUNT, &formats);
+	const auto getBinary = reinterpret_cast<ProgramBinary::GetFunction>(glfwGetProcAddress("glGetProgramBinary"));
+	const auto loadBinary = reinterpret_cast<ProgramBinary::LoadFunction>(glfwGetProcAddress("glProgramBinary"));
+	const auto setParameter = reinterpret_cast<ProgramBinary::ParameterFunction>(glfwGetProcAddress("glProgramParameteri"));
+	const bool caching = !cachePath.empty() && formats > 0 && getBinary && loadBinary && setParameter;
+	glGetError(); // The query fails without the extension
+	const auto key = ProgramBinary::Key({ vertexSource, fragmentSource, ProgramBinary::DriverString(GL_VENDOR),
+		ProgramBinary::DriverString(GL_RENDERER), ProgramBinary::DriverString(GL_VERSION) });
+
+	// Load the cached binary, if it is of these sources on this driver, and the driver takes it
+	int success = 0;
+	if (caching) {
+		std::ifstream file(cachePath, std::ios::binary);
+		ProgramBinary::Header header{};
+		if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+			header.magic == ProgramBinary::MAGIC && header.key == key) {
+			std::vector<char> binary(header.length);
+			if (file.read(binary.data(), binary.size())) {
+				loadBinary(id, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+				glGetProgramiv(id, GL_LINK_STATUS, &success);
+				glGetError();
+			}
+		}
 	}
+	cached = success;
+
+	// Else compile and link it, and cache it for the next run
+	if (!cached) {
+		Shader vertexShader(GL_VERTEX_SHADER, vertexSource, vertexShaderSource.path);
+		Shader fragmentShader(GL_FRAGMENT_SHADER, fragmentSource, fragmentShaderSource.path);
 
-	transformUniform = glGetUniformLocation(id, "transformUniform");
-	colorUniform = glGetUniformLocation(id, "colorUniform");
+		glAttachShader(id, vertexShader.getID());
+		glAttachShader(id, fragmentShader.getID());
+		if (caching) {
+			setParameter(id, ProgramBinary::RETRIEVABLE_HINT, GL_TRUE);
+		}
+		glLinkProgram(id);
+
+		glGetProgramiv(id, GL_LINK_STATUS, &success);
+		if (!success) {
+			char infoLog[512];
+			glGetProgramInfoLog(id, 512, nullptr, infoLog);
+			throw std::runtime_error(std::format("Could not link shader: {}", infoLog));
+		}
+
+		// A cache which can't be written is only a slower start next time
+		if (caching) {
+			GLint length = 0;
+			glGetProgramiv(id, ProgramBinary::LENGTH, &length);
+			std::vector<char> binary(length);
+			ProgramBinary::Header header{ ProgramBinary::MAGIC, key, 0, static_cast<uint32_t>(length) };
+			getBinary(id, length, nullptr, &header.format, binary.data());
+			if (length > 0 && glGetError() == GL_NO_ERROR) {
+				std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.write(binary.data(), binary.size());
+			}
+		}
+	}
 }
 
 ShaderProgram::ShaderProgram(ShaderProgram&& from) noexcept {
 	id = std::exchange(from.id, 0);
-	transformUniform = from.transformUniform;
-	colorUniform = from.colorUniform;
+	cached = from.cached;
+	drawCalls = from.drawCalls;
 }
 
 ShaderProgram& ShaderProgram::operator=(ShaderProgram&& from) noexcept {
 	id = std::exchange(from.id, 0);
-	transformUniform = from.transformUniform;
-	colorUniform = from.colorUniform;
+	cached = from.cached;
+	drawCalls = from.drawCalls;
 	return *this;
 }
 
@@ -106,10 +201,16 @@ ShaderProgram::~ShaderProgram() noexcept {
 	glDeleteProgram(id);
 }
 
-void ShaderProgram::Run(const glm::mat3 transform, const glm::vec4 color) {
+void ShaderProgram::RunInstanced(const size_t instances) {
 	glUseProgram(id);
-	glUniformMatrix3fv(transformUniform, 1, GL_FALSE, glm::value_ptr(transform));
-	glUniform4f(colorUniform, color.r, color.g, color.b, color.a);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
-	
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(instances));
+	++drawCalls;
+}
+
+size_t ShaderProgram::DrawCalls() const {
+	return drawCalls;
+}
+
+bool ShaderProgram::Cached() const {
+	return cached;
 }
\ No newline at end of file
@@ -1,32 +1,46 @@
 // This header defines the ShaderProgram class, which encapsulates an OpenGL program object
+// A program may be cached as the driver's binary of it (where the driver can, see glGetProgramBinary), which a later
+// run loads instead of compiling and linking the sources. The cache is keyed by the sources and the driver, and
+// a cache which doesn't match, or which the driver rejects, is simply replaced
 
 #pragma once
 
 #include <filesystem>
-#include "glm/glm.hpp"
+#include <cstddef>
+
+// The source of a shader, built in (see ShaderSources), and the file which Constants::SHADER_FILES loads instead
+struct ShaderSource {
+	const char* source;
+	std::filesystem::path path;
+};
 
 class ShaderProgram {
 public:
 	ShaderProgram() noexcept;
 
-	// Loads, compiles and links the shaders at the given paths to the program.
-	// The program is limited to the use of two uniforms:
-	// a 3x3 matrix named "transformUniform", and a 4d vector named "colorUniform"
-
-	ShaderProgram(const std::filesystem::path vertexShaderPath, const std::filesystem::path fragmentShaderPath);
+	// Compiles and links the shaders to the program, or loads it from the binary cache at cachePath, if any.
+	// The program takes no uniforms: what it draws comes from the per-instance attributes of the bound vertex array
+	ShaderProgram(const ShaderSource& vertexShader, const ShaderSource& fragmentShader,
+		const std::filesystem::path& cachePath = {});
 
 	ShaderProgram(ShaderProgram&& from) noexcept;
 	ShaderProgram& operator=(ShaderProgram&& from) noexcept;
 	~ShaderProgram() noexcept;
 
-	// Runs the program, i.e. draws, with the transform
-	void Run(const glm::mat3 transform, const glm::vec4 color);
+	// Runs the program once for instances instances of the bound vertex array, in a single draw call
+	void RunInstanced(const size_t instances);
+
+	// Returns the draw calls the program has issued
+	size_t DrawCalls() const;
+
+	// Was the program loaded from the binary cache?
+	bool Cached() const;
 
 	// ShaderProgram cannot be copied
 	ShaderProgram(const ShaderProgram&) = delete;
 	ShaderProgram& operator=(const ShaderProgram&) = delete;
 private:
 	unsigned int id{};
-	unsigned int transformUniform;
-	unsigned int colorUniform;
+	bool cached{};
+	size_t drawCalls{};
 };
\ No newline at end of file
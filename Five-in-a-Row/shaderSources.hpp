@@ -0,0 +1,17 @@
+// This header embeds the GLSL sources of the shaders in the program, so that it starts without reading
+// any files (and from any working directory). The .glsl files stay the sources: the build wraps each in a raw
+// string literal (the EmbedShaders target of the project), included here. To edit a shader without rebuilding,
+// set Constants::SHADER_FILES, which loads the files instead
+
+#pragma once
+
+namespace ShaderSources {
+
+	constexpr const char* BOARD_VERTEX =
+#include "boardVertexShader.glsl.inc"
+		;
+
+	constexpr const char* BOARD_FRAGMENT =
+#include "boardFragmentShader.glsl.inc"
+		;
+}
\ No newline at end of file
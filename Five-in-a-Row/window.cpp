@@ -26,12 +26,13 @@ uint8_t SetByte(const uint8_t byte, const uint8_t mask, const bool value) {
 	return (byte & ~mask) | (value ? mask : 0);
 }
 
-Window::Window() {
+Window::Window(const bool visible) {
 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	glfwWindowHint(GLFW_RESIZABLE, false);
+	glfwWindowHint(GLFW_VISIBLE, visible);
 
 	std::string title = std::string(APPLICATION_NAME) + (PLAYER_FIRST ? PLAYER_TURN_SUFFIX : COMPUTER_TURN_SUFFIX);
 	handle = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, title.c_str(), nullptr, nullptr);
@@ -40,6 +41,13 @@ Window::Window() {
 	}
 
 	glfwMakeContextCurrent(handle);
+	glfwSwapInterval(1);
+
+	// The window manager asks for a redraw when it has lost the contents
+	glfwSetWindowUserPointer(handle, this);
+	glfwSetWindowRefreshCallback(handle, [](GLFWwindow* handle) {
+		static_cast<Window*>(glfwGetWindowUserPointer(handle))->damaged = true;
+	});
 }
 
 Window::~Window() noexcept {
@@ -80,8 +88,16 @@ std::pair<double, double> Window::CursorPosition() const {
 	return std::make_pair(x, y);
 }
 
-void Window::Update() {
-	glfwPollEvents();
+void Window::Update(const double timeout) {
+	if (timeout == std::numeric_limits<double>::infinity()) {
+		glfwWaitEvents();
+	}
+	else if (timeout > 0.0) {
+		glfwWaitEventsTimeout(timeout);
+	}
+	else {
+		glfwPollEvents();
+	}
 
 	// Update input state
 	// We only want Clicked() to be true for the frame that the mouse button was released,
@@ -109,16 +125,35 @@ void Window::Update() {
 	inputState = SetByte(inputState, helpDownBit, glfwGetKey(handle, GLFW_KEY_H) == GLFW_PRESS);
 }
 
+void Window::Wake() {
+	glfwPostEmptyEvent();
+}
+
+bool Window::Damaged() const {
+	return damaged;
+}
+
 void Window::DrawFrame() {
 	glfwSwapBuffers(handle);
+	damaged = false;
 }
 
+// The refresh callback finds the window through the user pointer, so it follows the window
 Window::Window(Window&& other) noexcept :
 	handle(std::exchange(other.handle, nullptr)),
-	inputState(other.inputState) {}
+	inputState(other.inputState),
+	damaged(other.damaged) {
+	if (handle) {
+		glfwSetWindowUserPointer(handle, this);
+	}
+}
 
 Window& Window::operator=(Window&& other) noexcept {
 	handle = std::exchange(other.handle, nullptr);
 	inputState = other.inputState;
+	damaged = other.damaged;
+	if (handle) {
+		glfwSetWindowUserPointer(handle, this);
+	}
 	return *this;
 }
\ No newline at end of file
@@ -1,14 +1,17 @@
 // This header defines the Window class, which encapsulates a GLFW window and manages relevant input
+// The window doesn't poll: Update sleeps until there is input (or a timeout, or a Wake from another thread),
+// and the buffers are swapped in step with the display (a swap interval of 1)
 #pragma once
 
 #include <utility>
+#include <limits>
 
 struct GLFWwindow;
 
 class Window {
 public:
-	// Window parameters are defined in "constants.hpp"
-	Window();
+	// Window parameters are defined in "constants.hpp". A hidden window still draws (e.g. for checking the renderer)
+	explicit Window(const bool visible = true);
 	~Window() noexcept;
 
 	// Should the window close?
@@ -26,8 +29,14 @@ public:
 	// Returns the position of the cursor in window space
 	std::pair<double, double> CursorPosition() const;
 
-	// Polls events and updates the input state
-	void Update();
+	// Waits for events, at most timeout seconds (forever by default, not at all at 0), and updates the input state
+	void Update(const double timeout = std::numeric_limits<double>::infinity());
+
+	// Wakes the thread waiting in Update. Any thread may call it, while the library is initialized
+	static void Wake();
+
+	// Have the window's contents been lost (e.g. it was uncovered) since the last frame?
+	bool Damaged() const;
 
 	// Swaps the window buffers
 	void DrawFrame();
@@ -44,4 +53,7 @@ private:
 
 	// Reset pressed, mouse clicked
 	uint8_t inputState{};
+
+	// Set by the window's refresh callback, cleared by DrawFrame
+	bool damaged{ true };
 };
\ No newline at end of file
@@ -5,11 +5,8 @@ using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 using namespace Constants;
 
-// Returns 1.0f if red won, -1.0f if blue, and 0.0f if neither has won.
-float SimpleGoal(const Board&);
-
-// An allowed error, for floating point comparisons
-constexpr float EPSILON = 0.1f;
+// Returns 1 if red won, -1 if blue, and 0 if neither has won.
+Score SimpleGoal(const Board&);
 
 namespace UnitTests {
 
@@ -578,21 +575,21 @@ namespace UnitTests {
 
 			constexpr Minimax<0, true, SimpleGoal> Test0{};
 
-			Assert::AreEqual(1.0f, Test0(redWin), L"Test0: redWin");
-			Assert::AreEqual(-1.0f, Test0(blueWin), L"Test0: blueWin");
-			Assert::AreEqual(0.0f, Test0(redWinsInOne), L"Test0: redWinsInOne");
+			Assert::AreEqual(1, Test0(redWin), L"Test0: redWin");
+			Assert::AreEqual(-1, Test0(blueWin), L"Test0: blueWin");
+			Assert::AreEqual(0, Test0(redWinsInOne), L"Test0: redWinsInOne");
 
 			// Testing ply depth of 1
 
 			constexpr Minimax<1, true, SimpleGoal> Test1{};
 
-			Assert::AreEqual(1.0f, Test1(redWinsInOne), L"Test1: Red should see a win.");
+			Assert::AreEqual(1, Test1(redWinsInOne), L"Test1: Red should see a win.");
 
 			// Testing ply depth of 2
 
 			constexpr Minimax<2, false, SimpleGoal> Test2{};
 
-			Assert::AreEqual(0.0f, Test2(redWinsInOne), L"Test2: Blue should see the block.");
+			Assert::AreEqual(0, Test2(redWinsInOne), L"Test2: Blue should see the block.");
 
 			Board fourBsInARow(std::string() +
 				"***************" +
@@ -613,7 +610,7 @@ namespace UnitTests {
 
 			constexpr Minimax<2, true, SimpleGoal> Test3{};
 
-			Assert::AreEqual(-1.0f, Test3(fourBsInARow), L"Test3: Red should see that blue wins.");
+			Assert::AreEqual(-1, Test3(fourBsInARow), L"Test3: Red should see that blue wins.");
 
 			Board threeRsInARow(std::string() +
 				"***************" +
@@ -634,8 +631,8 @@ namespace UnitTests {
 
 			constexpr Minimax<3, true, SimpleGoal> Test4{};
 			constexpr Minimax<4, false, SimpleGoal> Test5{};
-			Assert::AreEqual(1.0f, Test4(threeRsInARow), L"Test4: Red should see a win");
-			Assert::AreEqual(0.0f, Test5(threeRsInARow), L"Test5: Blue should see two blocks.");
+			Assert::AreEqual(1, Test4(threeRsInARow), L"Test4: Red should see a win");
+			Assert::AreEqual(0, Test5(threeRsInARow), L"Test5: Blue should see two blocks.");
 		}
 
 		TEST_METHOD(ChildReturningMinimax) {
@@ -691,6 +688,964 @@ namespace UnitTests {
 				L"Test4: Red should see a win");
 		}
 
+		TEST_METHOD(BoardSizes) {
+			// Runtime dispatch
+			Assert::IsTrue(std::holds_alternative<BasicBoard<19, 19>>(MakeBoard(19, 19)), L"19x19");
+			Assert::IsTrue(std::holds_alternative<BasicBoard<7, 7>>(MakeBoard(7, 7)), L"7x7");
+			Assert::ExpectException<std::runtime_error>([]() {
+				MakeBoard(16, 16);
+			});
+
+			// Compile-time tables
+			Assert::AreEqual(static_cast<size_t>(15 * 19), BasicBoard<19, 19>::Geometry::HORIZONTAL_FIVES_ROOTS.size());
+			Assert::AreEqual(static_cast<size_t>(15 * 15), BasicBoard<19, 19>::Geometry::SOUTHWEST_FIVES_ROOTS.size());
+			Assert::AreEqual(static_cast<size_t>(3 * 7), BasicBoard<7, 7>::Geometry::VERTICAL_FIVES_ROOTS.size());
+
+			BasicBoard<7, 7> small(std::string() +
+				"*******" +
+				"*R*****" +
+				"**R****" +
+				"***R***" +
+				"****R**" +
+				"*******" +
+				"*******");
+			Assert::IsFalse(small.RedWin());
+			Assert::IsTrue(small.Play(5, 5, false).RedWin());
+			Assert::AreEqual(CellState::RED, small.At(4, 4));
+
+			// Blue must block the diagonal at either end
+			constexpr BasicMinimax<BasicBoard<7, 7>, 2, false, GoalFunction, true> Test0{};
+			const auto block = Test0(small);
+			Assert::IsTrue(block == 0 || block == 5 * 7 + 5, L"Test0: Blue should block.");
+
+			BasicBoard<19, 19> large = BasicBoard<19, 19>().Play(18, 18, false).Play(17, 17, false)
+				.Play(16, 16, false).Play(15, 15, false);
+			constexpr BasicMinimax<BasicBoard<19, 19>, 1, true, GoalFunction, true> Test1{};
+			const auto win = Test1(large);
+			Assert::IsTrue(large.Play(win, false).RedWin(), L"Test1: Red should win.");
+		}
+
+		TEST_METHOD(IncidenceTables) {
+			using Geometry = Board::Geometry;
+
+			// Corners are in one horizontal, one vertical and one diagonal "five", the center in 20
+			Assert::AreEqual(static_cast<uint8_t>(3), Geometry::CELL_FIVES_COUNT[0]);
+			Assert::AreEqual(static_cast<uint8_t>(3), Geometry::CELL_FIVES_COUNT[BOARD_SIZE - 1]);
+			Assert::AreEqual(static_cast<uint8_t>(MAX_CELL_FIVES), Geometry::CELL_FIVES_COUNT[BOARD_SIZE / 2]);
+			Assert::AreEqual(static_cast<size_t>(14945), Geometry::INCIDENCE_FOOTPRINT);
+			Assert::AreEqual(static_cast<size_t>(25001), BasicBoard<19, 19>::Geometry::INCIDENCE_FOOTPRINT);
+
+			// Every "five" through a cell contains it, and agrees with the root tables
+			for (size_t cell = 0; cell < BOARD_SIZE; ++cell) {
+				for (size_t i = 0; i < Geometry::CELL_FIVES_COUNT[cell]; ++i) {
+					const auto five = Geometry::CELL_FIVES[cell][i];
+					const auto& cells = Geometry::FIVE_CELLS[Geometry::FiveIndex(five)];
+					Assert::IsTrue(std::find(cells.begin(), cells.end(), cell) != cells.end(),
+						std::format(L"cell = {}, five = {}", cell, five).c_str());
+					const auto rootIndex = PackedFiveRootIndex(five);
+					switch (PackedFiveOrientation(five)) {
+					case 0: Assert::AreEqual(HORIZONTAL_FIVES_ROOTS[rootIndex], static_cast<size_t>(cells[0])); break;
+					case 1: Assert::AreEqual(VERTICAL_FIVES_ROOTS[rootIndex], static_cast<size_t>(cells[0])); break;
+					case 2: Assert::AreEqual(SOUTHEAST_FIVES_ROOTS[rootIndex], static_cast<size_t>(cells[0])); break;
+					default: Assert::AreEqual(SOUTHWEST_FIVES_ROOTS[rootIndex], static_cast<size_t>(cells[0])); break;
+					}
+				}
+			}
+
+			Board b(std::string() +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"****R**********" +
+				"*****R*********" +
+				"******R********" +
+				"*******R*******" +
+				"********R******" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"**********B****" +
+				"***************");
+			Assert::IsTrue(b.WinThrough(5 * BOARD_WIDTH + 4));
+			Assert::IsTrue(b.WinThrough(9 * BOARD_WIDTH + 8));
+			Assert::IsFalse(b.WinThrough(13 * BOARD_WIDTH + 10));
+			Assert::IsFalse(b.WinThrough(0));
+		}
+
+		TEST_METHOD(PatternGoalFunctionBehavior) {
+			Board redWin(std::string() +
+				"RRRRR**********" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"BBBB***********");
+			Assert::AreEqual(WIN_SCORE, PatternGoalFunction(redWin), L"redWin");
+			Assert::AreEqual(-WIN_SCORE, PatternGoalFunction(redWin.Reset(0).Play(4, 14, true)), L"blueWin");
+			Assert::IsFalse(redWin.Reset(4).RedWin(), L"Reset undoes the five");
+
+			// An open four is worth more than one blocked at the edge, or by the opponent
+			const Board openFour = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false).Play(8, 7, false);
+			const Board edgeFour = Board().Play(0, 7, false).Play(1, 7, false).Play(2, 7, false).Play(3, 7, false);
+			const Board blockedFour = openFour.Play(4, 7, true);
+			Assert::IsTrue(PatternGoalFunction(openFour) > PatternGoalFunction(edgeFour));
+			Assert::IsTrue(PatternGoalFunction(openFour) > PatternGoalFunction(blockedFour));
+			const Board blueFour = Board().Play(7, 5, true).Play(7, 6, true).Play(7, 7, true).Play(7, 8, true);
+			Assert::AreEqual(PatternGoalFunction(openFour), -PatternGoalFunction(blueFour), L"Symmetric between colors");
+
+			// The incremental totals match the totals of a board parsed in one go, and Reset undoes Play
+			Board real(std::string() +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"*********R*****" +
+				"****B**RB******" +
+				"*****BRBR******" +
+				"****RBBBR******" +
+				"*****RBBBR*****" +
+				"******BRR******" +
+				"******B********" +
+				"******R********" +
+				"***************" +
+				"***************" +
+				"***************");
+			Board played;
+			for (size_t pos = 0; pos < BOARD_SIZE; ++pos) {
+				if (real.At(pos) != CellState::EMPTY) played = played.Play(pos, real.At(pos) == CellState::BLUE);
+			}
+			Assert::AreEqual(PatternGoalFunction(real), PatternGoalFunction(played));
+			for (const auto pos : real.InRangePlies()) {
+				Assert::AreEqual(PatternGoalFunction(real), PatternGoalFunction(real.Play(pos, true).Reset(pos)),
+					std::format(L"pos = {}", pos).c_str());
+			}
+
+			// It finds the same block as the full goal function (see RealSituations)
+			constexpr Minimax<PLY_LOOK_AHEAD, true, PatternGoalFunction, true> Pattern{};
+			Assert::AreEqual(4 * BOARD_WIDTH + 3, Pattern(real), L"Red should block.");
+		}
+
+		TEST_METHOD(SymmetricKeys) {
+			Board b(std::string() +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"*********R*****" +
+				"****B**RB******" +
+				"*****BRBR******" +
+				"****RBBBR******" +
+				"*****RBBBR*****" +
+				"******BRR******" +
+				"******B********" +
+				"******R********" +
+				"***************" +
+				"***************" +
+				"***************");
+
+			// Keys are independent of move order, and Reset undoes Play
+			Assert::AreEqual(static_cast<uint64_t>(0), Board().Key());
+			Assert::AreEqual(Board().Play(3, true).Play(7, false).Key(), Board().Play(7, false).Play(3, true).Key());
+			Assert::AreNotEqual(Board().Play(3, true).Key(), Board().Play(3, false).Key());
+			Assert::AreEqual(b.Key(), b.Play(0, true).Reset(0).Key());
+
+			// A quarter turn maps the top left corner to the top right one, and the inverse maps it back
+			Assert::AreEqual(BOARD_WIDTH - 1, Board::Transform(0, 5));
+			for (uint8_t s = 0; s < Board::Geometry::SYMMETRY_COUNT; ++s) {
+				for (size_t pos = 0; pos < BOARD_SIZE; ++pos) {
+					Assert::AreEqual(pos, Board::InverseTransform(Board::Transform(pos, s), s));
+				}
+			}
+
+			// Every symmetric form has the same canonical key, reached through its own symmetry
+			const auto canonical = b.Canonical();
+			Assert::AreEqual(canonical.key, b.Transformed(canonical.symmetry).Key());
+			for (uint8_t s = 0; s < Board::Geometry::SYMMETRY_COUNT; ++s) {
+				const Board symmetric = b.Transformed(s);
+				Assert::AreEqual(canonical.key, symmetric.Canonical().key, std::format(L"s = {}", s).c_str());
+				Assert::AreEqual(PatternGoalFunction(b), PatternGoalFunction(symmetric), std::format(L"s = {}", s).c_str());
+			}
+			Assert::AreNotEqual(canonical.key, b.Play(0, true).Canonical().key);
+
+			// A move found on the canonical form maps back to this board
+			constexpr Minimax<PLY_LOOK_AHEAD, true, PatternGoalFunction, true> Pattern{};
+			Assert::AreEqual(4 * BOARD_WIDTH + 3,
+				Board::InverseTransform(Pattern(b.Transformed(canonical.symmetry)), canonical.symmetry));
+
+			// Boards which are not square have four symmetries, and 19x19 keys are independent of 15x15 ones
+			static_assert(BoardGeometry<15, 19>::SYMMETRY_COUNT == 4);
+			Assert::AreNotEqual(Board().Play(0, true).Key(), BasicBoard<19, 19>().Play(0, true).Key());
+		}
+
+		TEST_METHOD(OpeningBookBehavior) {
+			const auto path = std::filesystem::temp_directory_path() / "UnitTestsOpeningBook.bin";
+			std::filesystem::remove(path);
+
+			// A missing book is empty
+			Assert::AreEqual(static_cast<size_t>(0), OpeningBook(path).Size());
+			Assert::IsFalse(OpeningBook(path).Lookup(Board(), false).has_value());
+
+			// Red's positions with 0 to 2 pieces: the empty board, a blue piece anywhere (folded by symmetry)
+			// and red's first ply answered anywhere "in range"
+			const auto entries = OpeningBook::Search<2, PatternGoalFunction>(3, 2);
+			Assert::IsTrue(std::is_sorted(entries.begin(), entries.end(),
+				[](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; }));
+			Assert::AreEqual(static_cast<size_t>(1 + 36 + 2), entries.size());
+			OpeningBook::Write(path, entries);
+
+			{
+				const OpeningBook book(path);
+				Assert::AreEqual(entries.size(), book.Size());
+				Assert::AreEqual(BOARD_SIZE / 2, *book.Lookup(Board(), false));
+
+				// Symmetric positions get symmetric plies
+				const Board b = Board().Play(3, 5, true);
+				const auto ply = book.Lookup(b, false);
+				Assert::IsTrue(ply.has_value() && b.InRange(*ply));
+				for (uint8_t s = 0; s < Board::Geometry::SYMMETRY_COUNT; ++s) {
+					Assert::AreEqual(Board::Transform(*ply, s), *book.Lookup(b.Transformed(s), false),
+						std::format(L"s = {}", s).c_str());
+				}
+
+				// Positions outside of the book, or for blue, or on another size of board, are not found
+				Assert::IsFalse(book.Lookup(b.Play(*ply, false), false).has_value());
+				Assert::IsFalse(book.Lookup(b, true).has_value());
+				Assert::IsFalse(book.Lookup(BasicBoard<19, 19>(), false).has_value());
+			}
+
+			// A count which doesn't match the entries throws, even one whose size in bytes overflows to match
+			{
+				std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+				const uint64_t count = entries.size() + (uint64_t{ 1 } << 60);
+				file.seekp(16); // After the magic, version, width and height
+				file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+			}
+			Assert::ExpectException<std::runtime_error>([&]() { OpeningBook book(path); });
+
+			// A file which isn't a book throws
+			std::ofstream(path, std::ios::binary | std::ios::trunc) << "Not a book, but long enough to have a header";
+			Assert::ExpectException<std::runtime_error>([&]() { OpeningBook book(path); });
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(EvaluationCacheBehavior) {
+			auto& cache = EvaluationCache::Get();
+			cache.Clear();
+
+			// Keys in the same slot replace each other
+			const uint64_t key = 0x123456789ABCDEF0ull;
+			const uint64_t sameSlot = key ^ (1ull << 40);
+			Assert::IsFalse(cache.Find(key).has_value());
+			cache.Store(key, 15);
+			Assert::AreEqual(15, *cache.Find(key));
+			Assert::IsFalse(cache.Find(sameSlot).has_value());
+			cache.Store(sameSlot, -WIN_SCORE);
+			Assert::AreEqual(-WIN_SCORE, *cache.Find(sameSlot));
+			Assert::IsFalse(cache.Find(key).has_value());
+			Assert::AreEqual(static_cast<uint64_t>(2), cache.Statistics().hits);
+			Assert::AreEqual(static_cast<uint64_t>(3), cache.Statistics().misses);
+			Assert::AreEqual(0.4, cache.Statistics().HitRate());
+
+			// GoalFunction fills the cache, and is answered by it the second time
+			cache.Clear();
+			const Board b = Board().Play(3, 5, true).Play(4, 5, false).Play(4, 6, true);
+			const Score value = GoalFunction(b);
+			Assert::AreEqual(value, GoalFunctionThreadPool::Get()(&b));
+			Assert::AreEqual(value, GoalFunction(b));
+			Assert::AreEqual(static_cast<uint64_t>(1), cache.Statistics().hits);
+
+			// Concurrent readers and writers never see a value stored for another key
+			cache.Clear();
+			std::atomic<bool> torn{};
+			{
+				std::vector<std::jthread> threads;
+				for (uint64_t t = 0; t < 4; ++t) {
+					threads.emplace_back([&, t]() {
+						for (uint64_t i = 0; i < 100000; ++i) {
+							// Only a few slots, so that the threads keep overwriting each other
+							const uint64_t k = ((i * 4 + t) << 32) | (i % 8);
+							cache.Store(k, static_cast<int16_t>(k >> 32));
+							if (const auto found = cache.Find(k ^ (t << 32)); found && *found != static_cast<int16_t>((k ^ (t << 32)) >> 32)) {
+								torn = true;
+							}
+						}
+					});
+				}
+			}
+			Assert::IsFalse(torn);
+
+			// The lookups of the threads are counted, though they have exited
+			const auto statistics = cache.Statistics();
+			Assert::AreEqual(static_cast<uint64_t>(4 * 100000), statistics.hits + statistics.misses);
+			cache.Clear();
+		}
+
+		TEST_METHOD(SearchContextReuse) {
+			Board b(std::string() +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"*********R*****" +
+				"****B**RB******" +
+				"*****BRBR******" +
+				"****RBBBR******" +
+				"*****RBBBR*****" +
+				"******BRR******" +
+				"******B********" +
+				"******R********" +
+				"***************" +
+				"***************" +
+				"***************");
+			constexpr auto infinity = INFINITE_SCORE;
+
+			// Within a fixed depth search, transpositions are searched to the same depth, so the value is unchanged
+			SearchContext context;
+			constexpr Minimax<3, true, PatternGoalFunction> Value{};
+			Assert::AreEqual(Value(b), Value(b, -infinity, infinity, &context));
+			Assert::IsTrue(context.Statistics().probes > 0);
+
+			// The state of a search is reused by the search of a descendant
+			context.Clear();
+			Assert::AreEqual(static_cast<uint64_t>(0), context.Statistics().probes);
+			constexpr Minimax<PLY_LOOK_AHEAD, true, PatternGoalFunction, true> Red{};
+			constexpr Minimax<PLY_LOOK_AHEAD, false, PatternGoalFunction, true> Blue{};
+			const auto red = Red(b, -infinity, infinity, &context);
+			Assert::AreEqual(4 * BOARD_WIDTH + 3, red);
+			const Board descendant = b.Play(red, false);
+			const auto hits = context.Statistics().hits;
+			const auto blue = Blue(descendant, -infinity, infinity, &context);
+			Assert::IsTrue(descendant.At(blue) == CellState::EMPTY);
+			Assert::IsTrue(context.Statistics().hits > hits, L"The descendant's positions were found");
+
+			// The table doesn't confuse the color to move
+			SearchContext other;
+			other.Store(b.Key(), true, 1, 1, 0, Bound::EXACT);
+			Assert::IsTrue(other.Probe(b.Key(), true) != nullptr);
+			Assert::IsTrue(other.Probe(b.Key(), false) == nullptr);
+
+			// A hint of depth 0 doesn't evict a deeper entry of another position in its slot, but a search does
+			const auto collision = b.Key() + SearchContext::TABLE_SIZE;
+			other.Store(collision, true, 0, 0, 1, Bound::EXACT);
+			Assert::IsTrue(other.Probe(b.Key(), true) != nullptr);
+			Assert::IsTrue(other.Probe(collision, true) == nullptr);
+			other.Store(collision, true, 1, 0, 1, Bound::EXACT);
+			Assert::IsTrue(other.Probe(b.Key(), true) == nullptr);
+			Assert::IsTrue(other.Probe(collision, true) != nullptr);
+
+			// A lower bound from the table (here, one above the value) narrows the window, and a search which fails low
+			// against it has only found an upper bound, although its score lies within the window it was called with
+			SearchContext narrowed;
+			const Score value = Value(b);
+			narrowed.Store(b.Key(), true, 3, value + 1, 0, Bound::LOWER);
+			Assert::IsTrue(Value(b, -infinity, infinity, &narrowed) <= value + 1);
+			Assert::IsTrue(narrowed.Probe(b.Key(), true)->bound == Bound::UPPER);
+		}
+
+		TEST_METHOD(MateDistance) {
+			// Blue has a four (to be completed at (5, 2)) and an open three. Red loses either way,
+			// but blocking the four survives two plies longer
+			Board b(std::string() +
+				"***************" +
+				"***************" +
+				"RBBBB**********" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"**********B****" +
+				"**********B****" +
+				"**********B****" +
+				"***************" +
+				"***************" +
+				"******R********" +
+				"*******R*******" +
+				"***************" +
+				"***************");
+			constexpr Minimax<4, true, PatternGoalFunction, true> Red{};
+			Assert::AreEqual(2 * BOARD_WIDTH + 5, Red(b), L"Red should block the four.");
+			constexpr Minimax<4, true, PatternGoalFunction> Value{};
+			Assert::AreEqual(-WIN_SCORE, Value(b), L"Lost at the horizon");
+
+			// Blue wins right away, which is worth more than winning later
+			constexpr Minimax<3, false, PatternGoalFunction> BlueValue{};
+			Assert::AreEqual(-(WIN_SCORE + 2), BlueValue(b));
+			constexpr Minimax<3, false, PatternGoalFunction, true> Blue{};
+			Assert::AreEqual(2 * BOARD_WIDTH + 5, Blue(b), L"Blue should win.");
+
+			// The same holds with a transposition table, whose entries are relative to the position
+			SearchContext context;
+			constexpr auto infinity = INFINITE_SCORE;
+			Assert::AreEqual(-WIN_SCORE, Value(b, -infinity, infinity, &context));
+			Assert::AreEqual(-WIN_SCORE, Value(b, -infinity, infinity, &context), L"From the table");
+			Assert::AreEqual(2 * BOARD_WIDTH + 5, Red(b, -infinity, infinity, &context));
+		}
+
+		TEST_METHOD(IntegerScores) {
+			Board b(std::string() +
+				"***************" +
+				"***************" +
+				"***************" +
+				"**R************" +
+				"***R*****R*****" +
+				"****B**RB******" +
+				"*****BRBR******" +
+				"****RBBBRB*****" +
+				"***BBRBBBRBBBB*" +
+				"****RBBRRBR****" +
+				"****RRBBBRRR***" +
+				"******RRRB*****" +
+				"*******R*******" +
+				"********B******" +
+				"***************");
+
+			// The value is exact, so it is the same however the pool evaluates it
+			auto& pool = GoalFunctionThreadPool::Get();
+			const Score value = pool(&b);
+			Assert::AreEqual(value, pool.Inline(&b));
+			GoalFunctionThreadPool::Calibrate();
+			Assert::AreEqual(value, pool(&b), L"After calibration");
+
+			// Every value which isn't a win lies strictly within MAX_HEURISTIC_SCORE, and fits a 16-bit cache entry
+			for (const auto pos : b.InRangePlies()) {
+				for (const bool blue : { false, true }) {
+					const auto child = b.Play(pos, blue);
+					const Score score = pool(&child);
+					if (!child.RedWin() && !child.BlueWin()) {
+						Assert::IsTrue(-MAX_HEURISTIC_SCORE < score && score < MAX_HEURISTIC_SCORE, std::format(L"pos = {}", pos).c_str());
+					}
+					Assert::IsTrue(INT16_MIN <= score && score <= INT16_MAX);
+				}
+			}
+		}
+
+		TEST_METHOD(TacticalPlies) {
+			// Red has two in a row at (5, 7) and (6, 7), which blue has blocked at (8, 7)
+			const Board b = Board().Play(5, 7, false).Play(6, 7, false).Play(8, 7, true);
+			Assert::IsTrue(b.Tactical(7 * BOARD_WIDTH + 4, 2), L"Extends the two");
+			Assert::IsTrue(b.Tactical(7 * BOARD_WIDTH + 3, 2), L"Same five as the two, away from the block");
+			Assert::IsFalse(b.Tactical(7 * BOARD_WIDTH + 10, 2), L"Every five through it with red holds blue");
+			Assert::IsFalse(b.Tactical(7 * BOARD_WIDTH + 4, 3));
+			Assert::IsFalse(b.Tactical(9 * BOARD_WIDTH + 5, 2), L"Only one piece in any five through it");
+			Assert::IsTrue(b.Tactical(9 * BOARD_WIDTH + 5, 1));
+
+			// The prunings keep the forced wins: blue has an open four, which red can only block at one end
+			Board lost(std::string() +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"*****R*********" +
+				"******R**B*****" +
+				"*******R*B*****" +
+				"*********B*****" +
+				"*********B*****" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************" +
+				"***************");
+			constexpr Minimax<5, true, GoalFunction, true> Red{};
+			Assert::AreEqual(5 * BOARD_WIDTH + 9, Red(lost), L"Red should block an end");
+			constexpr Minimax<5, true, GoalFunction> Value{};
+			Assert::AreEqual(-(WIN_SCORE + 3), Value(lost), L"Lost in two plies");
+		}
+
+		TEST_METHOD(ThreatCandidates) {
+			using Plies = std::vector<size_t>;
+			auto at = [](const size_t x, const size_t y) -> size_t { return y * BOARD_WIDTH + x; };
+
+			// No threats, every in-range ply
+			const Board quiet = Board().Play(7, 7, false).Play(8, 8, true);
+			Assert::IsTrue(quiet.ThreatPlies(false).empty());
+			Assert::IsTrue(quiet.CandidatePlies(false) == quiet.InRangePlies());
+
+			// Blue has an open three at (5..7, 3): red blocks it at either end, or past them, or makes a four of its own
+			const Board three = Board().Play(5, 3, true).Play(6, 3, true).Play(7, 3, true)
+				.Play(2, 10, false).Play(3, 10, false).Play(4, 10, false);
+			Assert::IsTrue(Plies{ at(3, 3), at(4, 3), at(8, 3), at(9, 3), at(0, 10), at(1, 10), at(5, 10), at(6, 10) } ==
+				three.ThreatPlies(false), L"Defences");
+			Assert::IsTrue(Plies{ at(3, 3), at(4, 3), at(8, 3), at(9, 3), at(0, 10), at(1, 10), at(5, 10), at(6, 10) } ==
+				three.ThreatPlies(true), L"Symmetric for blue");
+
+			// Blue makes it an open four: red must block, unless it wins
+			const Board four = three.Play(4, 3, true);
+			Assert::IsTrue(Plies{ at(3, 3), at(8, 3) } == four.ThreatPlies(false), L"Block");
+			Assert::IsTrue(Plies{ at(3, 3), at(8, 3) } == four.ThreatPlies(true), L"Win");
+			const Board race = four.Play(5, 10, false);
+			Assert::IsTrue(Plies{ at(1, 10), at(6, 10) } == race.ThreatPlies(false), L"Winning beats blocking");
+		}
+
+		TEST_METHOD(DrawDetection) {
+			using SmallBoard = BasicBoard<7, 7>;
+			const SmallBoard full("RRBBRRBBBRRBBRRRBBRRBBBRRBBRRRBBRRBBBRRBBRRRBBRRB");
+			Assert::IsTrue(full.Full());
+			Assert::IsTrue(full.Drawn());
+
+			// Half empty, but every "five" holds both colors
+			const SmallBoard dead(std::string() +
+				"***BR**" +
+				"***RB**" +
+				"**B*R**" +
+				"BBR*BBR" +
+				"RRBBRRB" +
+				"**RRB**" +
+				"***BR**");
+			Assert::IsFalse(dead.Full());
+			Assert::IsTrue(dead.Drawn());
+			Assert::IsFalse(dead.Reset(4, 0).Drawn(), L"Reset revives a five");
+			Assert::IsTrue(dead.Reset(4, 0).Play(4, 0, false).Drawn());
+			Assert::IsFalse(SmallBoard().Drawn());
+			Assert::IsFalse(SmallBoard().Full());
+
+			// The search stops at once
+			constexpr BasicMinimax<SmallBoard, 4, true, PatternGoalFunction> Value{};
+			Assert::AreEqual(0, Value(dead));
+
+			// A full board has no ply: the roots answer none, and the computer rejects it
+			constexpr BasicMinimax<SmallBoard, 2, true, PatternGoalFunction, true> Best{};
+			Assert::AreEqual(SmallBoard::SIZE, Best(full));
+			Assert::IsTrue(BasicMultiPV<SmallBoard, 2, true, PatternGoalFunction>{}(full, 3).empty());
+			DecisionComputer computer(Engine::MINIMAX, 1);
+			Assert::ExpectException<std::invalid_argument>([&]() {
+				computer.Submit(AnyBoard(full), false);
+			});
+		}
+
+		TEST_METHOD(ProofSearchBehavior) {
+			// Red has an open three: it makes an open four, which blue can only block at one end
+			const Board three = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false)
+				.Play(6, 8, true).Play(7, 9, true);
+			ProofSearch search(16);
+			const auto won = search.Solve(three, false, {});
+			Assert::IsTrue(won.outcome == ProofOutcome::PROVEN);
+			Assert::IsTrue(won.ply == 7 * BOARD_WIDTH + 4 || won.ply == 7 * BOARD_WIDTH + 8, L"Red should make the open four");
+			Assert::IsTrue(three.Play(*won.ply, false).ThreatPlies(true).size() == 2, L"Two ends to block");
+			Assert::IsTrue(won.proofSize >= 4, L"The four, both blocks and the wins");
+			Assert::IsTrue(won.nodes > 0);
+
+			// Blue can't win it, but the board is too big to disprove in a few positions
+			const auto unknown = search.Solve(three, true, { 100 });
+			Assert::IsTrue(unknown.outcome == ProofOutcome::UNKNOWN);
+			Assert::IsTrue(unknown.nodes <= 100);
+
+			// A dead board can't be won by either color
+			const BasicBoard<7, 7> dead(std::string() +
+				"***BR**" +
+				"***RB**" +
+				"**B*R**" +
+				"BBR*BBR" +
+				"RRBBRRB" +
+				"**RRB**" +
+				"***BR**");
+			Assert::IsTrue(BasicProofSearch<7, 7>(8).Solve(dead, false, {}).outcome == ProofOutcome::DISPROVEN);
+			const auto almost = dead.Reset(4, 0);
+			const auto disproven = BasicProofSearch<7, 7>(8).Solve(almost, true, {});
+			Assert::IsTrue(disproven.outcome == ProofOutcome::DISPROVEN, L"Red blocks the only live five");
+
+			// A tiny table evicts, but the proof is still found, and in parallel too
+			ProofSearch tiny(4);
+			const auto evicted = tiny.Solve(three, false, {});
+			Assert::IsTrue(evicted.outcome == ProofOutcome::PROVEN);
+			Assert::IsTrue(evicted.evictions > 0);
+			const auto parallel = ProofSearch::SolveParallel(three, false, {}, 4);
+			Assert::IsTrue(parallel.outcome == ProofOutcome::PROVEN);
+			Assert::IsTrue(parallel.ply == 7 * BOARD_WIDTH + 4 || parallel.ply == 7 * BOARD_WIDTH + 8);
+			Assert::IsTrue(ProofSearch::SolveParallel(three, true, { 1000 }, 4).outcome == ProofOutcome::UNKNOWN);
+		}
+
+		TEST_METHOD(MonteCarloBehavior) {
+			// Red makes the open four out of its open three, and it wins every playout after
+			const Board three = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false)
+				.Play(6, 8, true).Play(7, 9, true);
+			MonteCarlo tree(16);
+			const auto four = tree.Search(three, false, { 2000 }, 1);
+			Assert::IsTrue(four.ply == 7 * BOARD_WIDTH + 4 || four.ply == 7 * BOARD_WIDTH + 8, L"Red should make the open four");
+			Assert::AreEqual(uint64_t{ 2000 }, four.playouts);
+			Assert::AreEqual(uint64_t{ 0 }, four.recycled);
+			Assert::IsTrue(four.winRate > 0.9);
+
+			// After blue blocks one end, the tree of the position is kept, and red completes the five
+			const auto blocked = three.Play(four.ply, false).Play(four.ply == 7 * BOARD_WIDTH + 4 ? 7 * BOARD_WIDTH + 8 :
+				7 * BOARD_WIDTH + 4, true);
+			const auto five = tree.Search(blocked, false, { 500 }, 1);
+			Assert::IsTrue(five.recycled > 0);
+			Assert::IsTrue(blocked.Play(five.ply, false).RedWin());
+
+			// Without the previous tree, nothing is recycled
+			tree.Clear();
+			Assert::AreEqual(uint64_t{ 0 }, tree.Search(blocked, false, { 500 }, 1).recycled);
+
+			// The threads share the tree, and a tiny tree just stops growing
+			const auto parallel = MonteCarlo(16).Search(three, false, { 4000 }, 4);
+			Assert::IsTrue(parallel.ply == 7 * BOARD_WIDTH + 4 || parallel.ply == 7 * BOARD_WIDTH + 8);
+			Assert::AreEqual(uint64_t{ 4000 }, parallel.playouts);
+			const auto tiny = MonteCarlo(5).Search(three, false, { 1000 }, 2);
+			Assert::IsTrue(tiny.nodes <= 32);
+			Assert::IsTrue(blocked.Play(MonteCarlo(5).Search(blocked, false, { 100 }, 2).ply, false).RedWin());
+		}
+
+		TEST_METHOD(MultiPVBehavior) {
+			const Board board = Board().Play(7, 7, false).Play(8, 8, true).Play(6, 7, false).Play(8, 7, true)
+				.Play(6, 6, false);
+			constexpr Minimax<3, false, PatternGoalFunction, true> Single{};
+			constexpr MultiPV<3, false, PatternGoalFunction> Multi{};
+			constexpr Minimax<2, true, PatternGoalFunction> Value{};
+
+			// One line is the single best ply, with its score
+			const auto one = Multi(board, 1);
+			Assert::AreEqual(size_t{ 1 }, one.size());
+			Assert::AreEqual(Single(board), one.front().ply);
+			Assert::AreEqual(Value(board.Play(one.front().ply, true)), one.front().score);
+
+			// More lines are the best plies, best (lowest, for blue) first, scored like full searches of them
+			const auto three = Multi(board, 3);
+			Assert::AreEqual(size_t{ 3 }, three.size());
+			Assert::AreEqual(one.front().ply, three.front().ply);
+			std::vector<Score> scores;
+			for (const auto ply : board.CandidatePlies(true)) {
+				scores.push_back(Value(board.Play(ply, true)));
+			}
+			std::sort(scores.begin(), scores.end());
+			for (size_t i = 0; i < three.size(); ++i) {
+				Assert::AreEqual(scores[i], three[i].score);
+				Assert::AreEqual(Value(board.Play(three[i].ply, true)), three[i].score);
+			}
+
+			// With a search context, every line has its variation, of legal plies
+			SearchContext context;
+			const auto lines = Multi(board, 3, &context);
+			Assert::AreEqual(one.front().ply, lines.front().ply);
+			for (const auto& line : lines) {
+				Assert::AreEqual(line.ply, line.variation.front());
+				Assert::IsTrue(line.variation.size() <= 3);
+				auto played = board;
+				bool blue = true;
+				for (const auto ply : line.variation) {
+					Assert::IsTrue(played.At(ply) == CellState::EMPTY);
+					played = played.Play(ply, blue);
+					blue = !blue;
+				}
+			}
+			Assert::IsTrue(lines.front().variation.size() == 3, L"The best line is searched to full depth");
+
+			// More lines than plies are just every ply
+			Assert::AreEqual(board.CandidatePlies(true).size(), Multi(board, 1000).size());
+		}
+
+		TEST_METHOD(PrincipalVariation) {
+			// Red's open three wins in three plies: the open four, either block, and the five
+			const Board three = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false)
+				.Play(6, 8, true).Play(7, 9, true);
+			constexpr Minimax<PLY_LOOK_AHEAD, true, PatternGoalFunction, true> Red{};
+			SearchContext context;
+			const auto ply = Red(three, -INFINITE_SCORE, INFINITE_SCORE, &context);
+			const auto won = context.Variation(PLY_LOOK_AHEAD);
+			Assert::AreEqual(size_t{ 3 }, won.size());
+			Assert::AreEqual(ply, won.front());
+			Assert::IsTrue(three.Play(won[0], false).Play(won[1], true).Play(won[2], false).RedWin());
+
+			// A quiet position's line is of legal plies, as long as the search at most
+			const Board quiet = Board().Play(7, 7, false).Play(8, 8, true).Play(6, 7, false).Play(8, 7, true);
+			context.Clear();
+			const auto first = Red(quiet, -INFINITE_SCORE, INFINITE_SCORE, &context);
+			const auto line = context.Variation(PLY_LOOK_AHEAD);
+			Assert::AreEqual(first, line.front());
+			Assert::IsTrue(line.size() <= PLY_LOOK_AHEAD);
+			auto played = quiet;
+			bool blue = false;
+			for (const auto reply : line) {
+				Assert::IsTrue(played.At(reply) == CellState::EMPTY);
+				played = played.Play(reply, blue);
+				blue = !blue;
+			}
+
+			// The line, once followed, is where the next search looks first
+			SearchContext next;
+			FollowVariation(quiet, true, line, next);
+			Assert::AreEqual(line[0], static_cast<size_t>(next.Probe(quiet.Key(), true)->ply));
+			Assert::AreEqual(line[1], static_cast<size_t>(next.Probe(quiet.Play(line[0], false).Key(), false)->ply));
+			Assert::AreEqual(size_t{ 0 }, static_cast<size_t>(next.Probe(quiet.Key(), true)->depth));
+		}
+
+		TEST_METHOD(DecisionComputerQueue) {
+			const Board three = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false)
+				.Play(6, 8, true).Play(7, 9, true);
+			const Board quiet = Board().Play(7, 7, false).Play(8, 8, true).Play(6, 7, false).Play(8, 7, true);
+			const Board other = Board().Play(7, 7, false).Play(6, 6, true).Play(8, 7, false).Play(8, 8, true);
+
+			// The position is copied in, and the answer comes through the future
+			DecisionComputer computer(Engine::MINIMAX, 1);
+			auto four = computer.Submit(AnyBoard(three), false);
+			const auto answer = four.get();
+			Assert::IsTrue(answer.ply == 7 * BOARD_WIDTH + 4 || answer.ply == 7 * BOARD_WIDTH + 8);
+			Assert::IsTrue(!answer.report.book);
+			Assert::AreEqual(answer.ply, answer.report.variation.front());
+			Assert::IsTrue(answer.analysis.empty());
+
+			// While the worker is busy, the higher priority is served first, whatever the order of submission
+			auto busy = computer.Submit(AnyBoard(quiet), false);
+			auto low = computer.Submit(AnyBoard(other), true, 0);
+			auto high = computer.Submit(AnyBoard(other), false, 5);
+			busy.get();
+			const auto served = high.get().report.queuedMilliseconds;
+			Assert::IsTrue(served < low.get().report.queuedMilliseconds);
+			Assert::AreEqual(size_t{ 0 }, computer.Queued());
+
+			// An analysis answers with its lines, the best of them the ply
+			const auto analysis = computer.Submit(AnyBoard(quiet), false, 0, 3).get();
+			Assert::AreEqual(size_t{ 3 }, analysis.analysis.size());
+			Assert::AreEqual(analysis.analysis.front().ply, analysis.ply);
+
+			// The state of a game is kept for its next position, until it is invalidated
+			Assert::IsTrue(computer.Submit(AnyBoard(quiet.Play(analysis.ply, false).Play(9, 9, true)), false).get().report.reused);
+			computer.Invalidate();
+			Assert::IsFalse(computer.Submit(AnyBoard(quiet), false).get().report.reused);
+
+			// Invalidating a game only forgets the state of that game
+			const auto followed = quiet.Play(analysis.ply, false).Play(9, 9, true);
+			Assert::IsFalse(computer.Submit(AnyBoard(quiet), false, 0, 0, {}, {}, 1).get().report.reused, L"Another game");
+			computer.Invalidate(2);
+			Assert::IsTrue(computer.Submit(AnyBoard(followed), false, 0, 0, {}, {}, 1).get().report.reused);
+			computer.Invalidate(1);
+			Assert::IsFalse(computer.Submit(AnyBoard(followed), false, 0, 0, {}, {}, 1).get().report.reused);
+
+			// The computer has the thread pool, so a second one of one worker searches inline, at the same time
+			Assert::IsFalse(GoalFunctionThreadPool::Claim(), L"The computer has the pool");
+			{
+				DecisionComputer second(Engine::MINIMAX, 1);
+				auto first = computer.Submit(AnyBoard(other), false);
+				auto inlined = second.Submit(AnyBoard(other), false);
+				for (const auto ply : { first.get().ply, inlined.get().ply }) {
+					Assert::IsTrue(other.At(ply) == CellState::EMPTY);
+				}
+			}
+
+			// Several workers answer several games at once, with their own state
+			{
+				DecisionComputer shared(Engine::MINIMAX, 2);
+				std::vector<std::future<Decision>> futures;
+				for (const auto& board : { three, quiet, other, three }) {
+					futures.push_back(shared.Submit(AnyBoard(board), false));
+				}
+				for (auto& future : futures) {
+					const auto ply = future.get().ply;
+					Assert::IsTrue(ply < BOARD_SIZE);
+				}
+			}
+
+			// The requests still queued when the computer goes are abandoned
+			std::future<Decision> abandoned;
+			{
+				DecisionComputer leaving(Engine::MINIMAX, 1);
+				leaving.Submit(AnyBoard(quiet), false);
+				abandoned = leaving.Submit(AnyBoard(other), false);
+			}
+			bool thrown = false;
+			try {
+				abandoned.get();
+			}
+			catch (const std::future_error&) {
+				thrown = true;
+			}
+			Assert::IsTrue(thrown);
+		}
+
+		TEST_METHOD(SearchProgressBehavior) {
+			// Nothing is published before the search begins
+			SearchProgress progress;
+			Assert::AreEqual(uint64_t{ 0 }, progress.Read().updates);
+
+			// The root publishes once before its children, and after every one of them, ending at the ply it plays
+			const Board quiet = Board().Play(7, 7, false).Play(8, 8, true).Play(6, 7, false).Play(8, 7, true);
+			constexpr Minimax<PLY_LOOK_AHEAD, true, PatternGoalFunction, true> Red{};
+			SearchContext context;
+			const auto ply = Red(quiet, -INFINITE_SCORE, INFINITE_SCORE, &context, &progress);
+			const auto done = progress.Read();
+			Assert::AreEqual(ply, done.ply);
+			Assert::AreEqual(PLY_LOOK_AHEAD, done.depth);
+			Assert::IsTrue(done.total > 0);
+			Assert::AreEqual(done.total, done.searched);
+			Assert::AreEqual(done.total + 1, done.updates);
+
+			// A reader never sees a half written snapshot
+			SearchProgress shared;
+			std::atomic<bool> stop{};
+			std::thread writer([&]() {
+				for (uint64_t i = 1; !stop.load(); ++i) {
+					shared.Publish({ i, static_cast<Score>(i), i, i, i, 0 });
+				}
+			});
+			for (size_t i = 0; i < 100000; ++i) {
+				const auto read = shared.Read();
+				Assert::IsTrue(read.ply == read.depth && read.depth == read.searched && read.searched == read.total &&
+					read.total == read.updates);
+			}
+			stop = true;
+			writer.join();
+
+			// The decision computer passes the progress on to its engine, whichever it is
+			for (const auto engine : { Engine::MINIMAX, Engine::MONTE_CARLO }) {
+				DecisionComputer computer(engine, 1);
+				auto followed = std::make_shared<SearchProgress>();
+				const auto decided = computer.Submit(AnyBoard(quiet), false, 0, 0, followed).get();
+				Assert::IsTrue(followed->Read().updates > 0);
+				Assert::AreEqual(decided.ply, followed->Read().ply);
+			}
+		}
+
+		TEST_METHOD(GameClockBehavior) {
+			using std::chrono::milliseconds;
+			const Board quiet = Board().Play(7, 7, false).Play(8, 8, true).Play(6, 7, false).Play(8, 7, true)
+				.Play(5, 5, false).Play(9, 9, true);
+			const Board three = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false)
+				.Play(6, 8, true).Play(7, 9, true).Play(12, 12, true);
+			const GameClock clock{ milliseconds(60000), milliseconds(1000) };
+
+			// A single forced ply gets no time: blue must block the four
+			const auto four = three.Play(4, 7, true).Play(8, 7, false);
+			Assert::AreEqual(int64_t{ 0 }, static_cast<int64_t>(AllocateTime(four, true, clock).maximum.count()));
+
+			// A position with threats gets more than a quiet one, and neither gets more than its part of the clock
+			const auto calm = AllocateTime(quiet, false, clock);
+			const auto critical = AllocateTime(three, true, clock);
+			Assert::IsTrue(calm.target.count() > 0);
+			Assert::IsTrue(critical.target > calm.target);
+			for (const auto& allocation : { calm, critical }) {
+				Assert::IsTrue(allocation.target <= allocation.maximum);
+				Assert::IsTrue(allocation.maximum <= clock.remaining / CLOCK_MAXIMUM_SHARE + clock.increment);
+			}
+			// ...and less time left means less time
+			Assert::IsTrue(AllocateTime(quiet, false, { milliseconds(6000), milliseconds(0) }).target < calm.target);
+
+			// With the time for it, the search deepens to its last depth, and plays what that depth's search does
+			SearchContext context;
+			constexpr IterativeDeepening<3, true, PatternGoalFunction> Deepening{};
+			const auto deep = Deepening(quiet, { milliseconds(60000), milliseconds(60000) }, &context);
+			Assert::AreEqual(size_t{ 3 }, deep.depth);
+			Assert::IsTrue(deep.finished);
+			Assert::AreEqual(deep.ply, deep.variation.front());
+			SearchContext fixed;
+			constexpr Minimax<3, true, PatternGoalFunction, true> Red{};
+			Assert::AreEqual(Red(quiet, -INFINITE_SCORE, INFINITE_SCORE, &fixed), deep.ply);
+
+			// Out of time within an iteration, the search stops within a root child, instead of finishing it
+			// (where an iteration doesn't already end just before the maximum)
+			constexpr IterativeDeepening<CLOCK_MAX_DEPTH, true, PatternGoalFunction> Deep{};
+			context.Clear();
+			const auto begun = std::chrono::steady_clock::now();
+			const auto stopped = Deep(quiet, { milliseconds(50), milliseconds(50) }, &context);
+			Assert::IsTrue(std::chrono::steady_clock::now() - begun < milliseconds(1000), L"Stopped near the maximum");
+			Assert::IsTrue(quiet.At(stopped.ply) == CellState::EMPTY);
+			Assert::AreEqual(stopped.ply, stopped.variation.front(), L"The variation of the iteration which chose it");
+			Assert::IsFalse(context.Expired(), L"The deadline is removed after the search");
+
+			// An unfinished iteration which didn't search the previous ply first (here, the table's entry for the root
+			// is a deeper one with another ply) may not have searched it at all, so the previous ply stands
+			SearchContext seeded;
+			seeded.Store(quiet.Key(), true, CLOCK_MAX_DEPTH, 0, 0, Bound::EXACT);
+			constexpr IterativeDeepening<2, true, PatternGoalFunction> Two{};
+			const auto kept = Two(quiet, { milliseconds(60000), milliseconds(0) }, &seeded);
+			Assert::AreEqual(size_t{ 1 }, kept.depth);
+			Assert::IsTrue(kept.finished);
+			constexpr Minimax<1, true, PatternGoalFunction, true> One{};
+			Assert::AreEqual(One(quiet), kept.ply);
+
+			// Without any, it stops after the first depth, which still finds the win
+			context.Clear();
+			const auto shallow = Deepening(four.Play(0, 14, true), { milliseconds(0), milliseconds(0) }, &context);
+			Assert::AreEqual(size_t{ 1 }, shallow.depth);
+			Assert::AreEqual(size_t{ 7 * BOARD_WIDTH + 9 }, shallow.ply);
+
+			// The decision computer reports the time it was allocated and the depth it reached
+			DecisionComputer computer(Engine::MINIMAX, 1);
+			const auto timed = computer.Submit(AnyBoard(quiet), false, 0, 0, {}, clock).get().report;
+			Assert::IsTrue(timed.allocatedMilliseconds > 0.0);
+			Assert::IsTrue(timed.depth >= 1 && timed.depth <= CLOCK_MAX_DEPTH);
+			Assert::IsFalse(timed.variation.empty());
+			const auto untimed = computer.Submit(AnyBoard(quiet), false).get().report;
+			Assert::AreEqual(0.0, untimed.allocatedMilliseconds);
+			Assert::AreEqual(PLY_LOOK_AHEAD, untimed.depth);
+		}
+
+		TEST_METHOD(RootTactics) {
+			// Red's open three, which one ply makes an open four at either end
+			const Board three = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false)
+				.Play(6, 8, true).Play(7, 9, true);
+			Assert::AreEqual(size_t{ 2 }, three.ThreatsAt(7 * BOARD_WIDTH + 4, false));
+			Assert::AreEqual(size_t{ 1 }, three.ThreatsAt(7 * BOARD_WIDTH + 3, false));
+			Assert::AreEqual(size_t{ 0 }, three.ThreatsAt(7 * BOARD_WIDTH + 4, true));
+			const auto open = ForcedPly(three, false);
+			Assert::IsTrue(open.has_value());
+			Assert::IsTrue(open->tactic == Tactic::DOUBLE_THREAT);
+			Assert::IsTrue(open->ply == 7 * BOARD_WIDTH + 4 || open->ply == 7 * BOARD_WIDTH + 8);
+
+			// Once blue has closed one end, red's four must be blocked at the other, and else it wins there
+			const auto four = three.Play(4, 7, true).Play(8, 7, false);
+			Assert::IsTrue(four.WinsAt(7 * BOARD_WIDTH + 9, false));
+			Assert::IsFalse(four.WinsAt(7 * BOARD_WIDTH + 9, true));
+			const auto block = ForcedPly(four, true);
+			Assert::IsTrue(block.has_value() && block->tactic == Tactic::BLOCK);
+			Assert::AreEqual(size_t{ 7 * BOARD_WIDTH + 9 }, block->ply);
+			const auto win = ForcedPly(four.Play(0, 14, true), false);
+			Assert::IsTrue(win.has_value() && win->tactic == Tactic::WIN);
+			Assert::AreEqual(size_t{ 7 * BOARD_WIDTH + 9 }, win->ply);
+
+			// Winning comes before blocking: blue's own four wins instead
+			const auto race = four.Play(2, 0, true).Play(3, 0, true).Play(4, 0, true).Play(5, 0, true);
+			const auto first = ForcedPly(race, true);
+			Assert::IsTrue(first.has_value() && first->tactic == Tactic::WIN);
+			Assert::IsTrue(race.Play(first->ply, true).BlueWin());
+
+			// Nothing is forced in a quiet position, nor when two fours can't both be blocked
+			const Board quiet = Board().Play(7, 7, false).Play(8, 8, true).Play(6, 7, false).Play(8, 7, true);
+			Assert::IsFalse(ForcedPly(quiet, false).has_value());
+			const auto lost = four.Play(0, 14, true).Play(10, 3, false).Play(10, 4, false).Play(10, 5, false)
+				.Play(10, 6, false).Play(1, 14, true);
+			Assert::IsFalse(ForcedPly(lost, true).has_value());
+
+			// The decision computer answers a forced ply without queueing it, and counts it
+			DecisionComputer computer(Engine::MINIMAX, 1);
+			const auto decided = computer.Submit(AnyBoard(four), true).get();
+			Assert::IsTrue(decided.report.tactic == Tactic::BLOCK);
+			Assert::AreEqual(size_t{ 7 * BOARD_WIDTH + 9 }, decided.ply);
+			Assert::IsTrue(computer.Submit(AnyBoard(quiet), false).get().report.tactic == Tactic::NONE);
+			const auto tactics = computer.Tactics();
+			Assert::AreEqual(uint64_t{ 2 }, tactics.checks);
+			Assert::AreEqual(uint64_t{ 1 }, tactics.blocks);
+			Assert::AreEqual(uint64_t{ 0 }, tactics.wins + tactics.doubleThreats);
+		}
+
+		TEST_METHOD(DecisionComputerNotifies) {
+			// Every answer calls back once it is ready, whether it was searched or forced
+			std::atomic<int> calls{};
+			DecisionComputer computer(Engine::MINIMAX, 1, [&]() { ++calls; });
+			const Board quiet = Board().Play(7, 7, false).Play(8, 8, true).Play(6, 7, false).Play(8, 7, true);
+			auto searched = computer.Submit(AnyBoard(quiet), false);
+			searched.wait();
+			const Board four = Board().Play(5, 7, false).Play(6, 7, false).Play(7, 7, false).Play(8, 7, false)
+				.Play(4, 7, true).Play(0, 14, true);
+			auto forced = computer.Submit(AnyBoard(four), true);
+			Assert::IsTrue(forced.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+			// The call follows the answer, so it may lag the future a little
+			while (calls < 2) {
+				std::this_thread::yield();
+			}
+			Assert::AreEqual(2, calls.load());
+		}
+
 		TEST_METHOD(GoalFunctionBehavior) {
 			Board redWin(std::string() +
 				"R**************" +
@@ -726,8 +1681,8 @@ namespace UnitTests {
 				"****B**********" +
 				"***B***********");
 
-			Assert::AreEqual(std::numeric_limits<float>::infinity(), GoalFunction(redWin), L"redWin");
-			Assert::AreEqual(-std::numeric_limits<float>::infinity(), GoalFunction(blueWin), L"blueWin");
+			Assert::AreEqual(WIN_SCORE, GoalFunction(redWin), L"redWin");
+			Assert::AreEqual(-WIN_SCORE, GoalFunction(blueWin), L"blueWin");
 
 			Board b(std::string() +
 				"R**************" +		// Horizontal 1Rs: 1, 2, 3, 4, 8					   | 1Rs: 40
@@ -746,14 +1701,14 @@ namespace UnitTests {
 				"****B**********" +		//
 				"***B***********");		//
 
-			float actual = GoalFunction(b);
-			float expected = 40 * SCORE_MAP[0] +
+			Score actual = GoalFunction(b);
+			Score expected = 40 * SCORE_MAP[0] +
 				3 * SCORE_MAP[1] +
 				132 * -SCORE_MAP[0] +
 				11 * -SCORE_MAP[1] +
 				3 * -SCORE_MAP[2] +
 				4 * -SCORE_MAP[3];
-			Assert::IsTrue(fabsf(expected - actual) < EPSILON, std::format(L"Expected: <{}>. Actual: <{}>", expected, actual).c_str());
+			Assert::AreEqual(expected, actual);
 		}
 
 		TEST_METHOD(RealSituations) {
@@ -820,8 +1775,8 @@ namespace UnitTests {
 	};
 }
 
-float SimpleGoal(const Board& board) {
-	if (board.RedWin()) return 1.0f;
-	if (board.BlueWin()) return -1.0f;
-	return 0.0f;
+Score SimpleGoal(const Board& board) {
+	if (board.RedWin()) return 1;
+	if (board.BlueWin()) return -1;
+	return 0;
 }
\ No newline at end of file
@@ -3,9 +3,24 @@
 #include "../Five-in-a-Row/board.hpp"
 #include "../Five-in-a-Row/minimax.hpp"
 #include "../Five-in-a-Row/goalFunction.hpp"
+#include "../Five-in-a-Row/patternGoalFunction.hpp"
+#include "../Five-in-a-Row/openingBook.hpp"
+#include "../Five-in-a-Row/evaluationCache.hpp"
+#include "../Five-in-a-Row/searchContext.hpp"
+#include "../Five-in-a-Row/proofSearch.hpp"
+#include "../Five-in-a-Row/monteCarlo.hpp"
+#include "../Five-in-a-Row/decisionComputer.hpp"
+#include "../Five-in-a-Row/searchProgress.hpp"
+#include "../Five-in-a-Row/gameClock.hpp"
+#include "../Five-in-a-Row/rootTactics.hpp"
 
 #include <format>
 #include <vector>
+#include <variant>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <atomic>
 
 namespace Microsoft::VisualStudio::CppUnitTestFramework {
 